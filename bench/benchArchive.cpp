@@ -0,0 +1,108 @@
+/**
+ * @file benchArchive.cpp
+ * @brief Throughput and compression benchmark for the columnar PV archive.
+ *
+ * Encodes synthetic monitor streams shaped like typical scalar PVs, decodes them again,
+ * checks the round trip and reports size reduction and samples per second on one core.
+ * Usage: benchArchive [samples_per_pv] [archive_path] [json_file]
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "caArchive.h"
+#include "benchUtil.h"
+
+using namespace epics;
+
+int main(int argc, char** argv) {
+    std::size_t samples = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 2000000;
+    std::string path = argc > 2 ? argv[2] : "/tmp/benchArchive.epa";
+    std::string json = argc > 3 ? argv[3] : "";
+
+    //A 10 Hz scan with a few microseconds of jitter, as an IOC time stamps it
+    std::vector<std::string> names = {"bench:motor.RBV", "bench:motor.MSTA", "bench:temp", "bench:current"};
+    std::mt19937_64 rng(42);
+    std::normal_distribution<double> jitter(0.0, 2000.0);
+    std::normal_distribution<double> noise(0.0, 1.0);
+    int64_t start = 1000000000LL * 1000000000LL;
+    std::vector<std::vector<archiveSample>> series(names.size(), std::vector<archiveSample>(samples));
+    for (std::size_t i = 0; i < samples; i++) {
+        int64_t tick = start + static_cast<int64_t>(i) * 100000000LL;
+        int64_t stamp = tick + static_cast<int64_t>(jitter(rng));
+        //Readback moving in encoder steps, idle most of the time
+        double position = std::round(100.0 * std::sin(i / 5000.0) * ((i / 1000) % 4 == 0)) / 1000.0;
+        series[0][i] = {stamp, position};
+        //Status word that rarely changes
+        series[1][i] = {stamp, (i / 20000) % 2 ? 258.0 : 2.0};
+        //Temperature with ADC resolution of 0.01
+        series[2][i] = {stamp, std::round((22.0 + 0.5 * std::sin(i / 30000.0) + 0.02 * noise(rng)) * 100.0) / 100.0};
+        //Full precision noisy reading, the worst case for XOR compression
+        series[3][i] = {tick, 1.5 + 0.001 * noise(rng)};
+    }
+    std::size_t total = samples * names.size();
+
+    auto t0 = std::chrono::steady_clock::now();
+    caArchiveWriter writer(path, names);
+    for (std::size_t i = 0; i < samples; i++) {
+        for (uint32_t pv = 0; pv < names.size(); pv++) {
+            writer.append(pv, series[pv][i].timestamp, series[pv][i].value);
+        }
+    }
+    writer.close();
+    auto t1 = std::chrono::steady_clock::now();
+
+    caArchiveReader reader(path);
+    std::size_t mismatches = 0;
+    for (uint32_t pv = 0; pv < names.size(); pv++) {
+        std::vector<archiveSample> decoded = reader.read(pv);
+        if (decoded.size() != samples) {
+            mismatches += samples;
+            continue;
+        }
+        for (std::size_t i = 0; i < samples; i++) {
+            if (decoded[i].timestamp != series[pv][i].timestamp || decoded[i].value != series[pv][i].value) {
+                mismatches++;
+            }
+        }
+    }
+    auto t2 = std::chrono::steady_clock::now();
+
+    double encode_s = std::chrono::duration<double>(t1 - t0).count();
+    double decode_s = std::chrono::duration<double>(t2 - t1).count();
+    double raw_bytes = static_cast<double>(total) * sizeof(archiveSample);
+    double ring_bytes = static_cast<double>(total) * 64.0;
+    double archive_bytes = static_cast<double>(writer.get_bytes_written());
+
+    bench::report report("caArchive");
+    report.set_config("samples_per_pv", std::to_string(samples));
+    report.add("archive_all", {{"samples", static_cast<double>(total)},
+                               {"bytes", archive_bytes},
+                               {"bits_per_sample", archive_bytes * 8.0 / total},
+                               {"ratio_vs_samples", raw_bytes / archive_bytes},
+                               {"ratio_vs_ring", ring_bytes / archive_bytes},
+                               {"encode_msamples_per_s", total / encode_s / 1e6},
+                               {"decode_msamples_per_s", total / decode_s / 1e6},
+                               {"mismatches", static_cast<double>(mismatches)}});
+
+    //Size of each signal on its own, to show which shapes compress well
+    for (uint32_t pv = 0; pv < names.size(); pv++) {
+        caArchiveWriter single(path + ".single", {names[pv]});
+        for (const archiveSample& sample : series[pv]) {
+            single.append(0, sample.timestamp, sample.value);
+        }
+        single.close();
+        double bytes = static_cast<double>(single.get_bytes_written());
+        report.add("archive_" + names[pv], {{"bits_per_sample", bytes * 8.0 / samples},
+                                            {"ratio_vs_samples", samples * sizeof(archiveSample) / bytes}});
+    }
+    std::remove((path + ".single").c_str());
+    report.write(json);
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,136 @@
+/**
+ * @file benchConvert.cpp
+ * @brief Throughput of the caConvert array kernels per element type and SIMD level.
+ *
+ * Converts a buffer of each DBR element type to double, unscaled and with a scale and
+ * offset, at every SIMD level the CPU supports, and checks that all levels agree to within
+ * the last bit (a fused multiply-add may round differently). Then reduces the same buffers
+ * to statistics at every level; min and max must match exactly, the sums to rounding.
+ * Needs no IOC.
+ * Usage: benchConvert [--elements N] [--rounds N] [--json FILE]
+ */
+
+#include <cstdlib>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include "caConvert.h"
+#include "benchUtil.h"
+
+using namespace epics;
+
+template<typename Wire>
+static void bench_type(bench::report& report, std::string m_name, std::size_t m_elements, int m_rounds, bool& m_agree) {
+    std::vector<Wire> source(m_elements);
+    for (std::size_t i = 0; i < m_elements; i++) {
+        source[i] = static_cast<Wire>((i * 2654435761u) % 251);
+    }
+    std::vector<double> reference(m_elements);
+    std::vector<double> out(m_elements);
+    simdLevel best = caConvert::detected();
+    for (int scaled = 0; scaled < 2; scaled++) {
+        double scale = scaled ? 0.0125 : 1.0;
+        double offset = scaled ? -3.5 : 0.0;
+        for (int level = SIMD_SCALAR; level <= best; level++) {
+            caConvert::set_level(static_cast<simdLevel>(level));
+            std::vector<double> samples;
+            for (int round = 0; round < m_rounds; round++) {
+                auto t0 = bench::clock::now();
+                caConvert::to_double(source.data(), out.data(), m_elements, scale, offset);
+                samples.push_back(bench::elapsed_us(t0, bench::clock::now()));
+            }
+            if (level == SIMD_SCALAR) {
+                reference = out;
+            } else {
+                for (std::size_t i = 0; i < m_elements; i++) {
+                    if (std::fabs(out[i] - reference[i]) > 1e-15 * std::max(1.0, std::fabs(reference[i]))) {
+                        m_agree = false;
+                    }
+                }
+            }
+            auto metrics = bench::summarize(samples);
+            metrics.push_back({"elements", static_cast<double>(m_elements)});
+            metrics.push_back({"ns_per_element", metrics[3].second * 1000.0 / m_elements});
+            metrics.push_back({"gb_per_s_out", m_elements * sizeof(double) / (metrics[3].second * 1000.0)});
+            report.add(m_name + (scaled ? "_scaled_" : "_") + caConvert::level_name(static_cast<simdLevel>(level)), metrics);
+        }
+    }
+    caConvert::set_level(best);
+}
+
+template<typename Wire>
+static void bench_reduce(bench::report& report, std::string m_name, chtype m_type, std::size_t m_elements, int m_rounds, bool& m_agree) {
+    std::vector<Wire> source(m_elements);
+    for (std::size_t i = 0; i < m_elements; i++) {
+        source[i] = static_cast<Wire>((i * 2654435761u) % 251);
+    }
+    simdLevel best = caConvert::detected();
+    arrayStats reference;
+    for (int level = SIMD_SCALAR; level <= best; level++) {
+        caConvert::set_level(static_cast<simdLevel>(level));
+        std::vector<double> samples;
+        arrayStats stats;
+        for (int round = 0; round < m_rounds; round++) {
+            auto t0 = bench::clock::now();
+            stats = caConvert::reduce(source.data(), m_type, m_elements);
+            samples.push_back(bench::elapsed_us(t0, bench::clock::now()));
+        }
+        if (level == SIMD_SCALAR) {
+            reference = stats;
+        } else if (stats.min != reference.min || stats.max != reference.max
+                   || std::fabs(stats.sum - reference.sum) > 1e-12 * std::fabs(reference.sum)
+                   || std::fabs(stats.weighted - reference.weighted) > 1e-12 * std::fabs(reference.weighted)) {
+            m_agree = false;
+        }
+        auto metrics = bench::summarize(samples);
+        metrics.push_back({"elements", static_cast<double>(m_elements)});
+        metrics.push_back({"ns_per_element", metrics[3].second * 1000.0 / m_elements});
+        metrics.push_back({"gb_per_s_in", m_elements * sizeof(Wire) / (metrics[3].second * 1000.0)});
+        report.add("reduce_" + m_name + "_" + caConvert::level_name(static_cast<simdLevel>(level)), metrics);
+    }
+    caConvert::set_level(best);
+}
+
+int main(int argc, char** argv) {
+    std::size_t elements = 1048576;
+    int rounds = 200;
+    std::string json;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--elements" && i + 1 < argc) {
+            elements = static_cast<std::size_t>(std::atol(argv[++i]));
+        } else if (arg == "--rounds" && i + 1 < argc) {
+            rounds = std::atoi(argv[++i]);
+        } else if (arg == "--json" && i + 1 < argc) {
+            json = argv[++i];
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--elements N] [--rounds N] [--json FILE]" << std::endl;
+            return 2;
+        }
+    }
+
+    bench::report report("Convert");
+    report.set_config("elements", std::to_string(elements));
+    report.set_config("detected", caConvert::level_name(caConvert::detected()));
+    bool agree = true;
+    bench_type<dbr_double_t>(report, "double", elements, rounds, agree);
+    bench_type<dbr_float_t>(report, "float", elements, rounds, agree);
+    bench_type<dbr_long_t>(report, "long", elements, rounds, agree);
+    bench_type<dbr_short_t>(report, "short", elements, rounds, agree);
+    bench_type<dbr_enum_t>(report, "enum", elements, rounds, agree);
+    bench_type<dbr_char_t>(report, "char", elements, rounds, agree);
+    bench_reduce<dbr_double_t>(report, "double", DBR_DOUBLE, elements, rounds, agree);
+    bench_reduce<dbr_float_t>(report, "float", DBR_FLOAT, elements, rounds, agree);
+    bench_reduce<dbr_long_t>(report, "long", DBR_LONG, elements, rounds, agree);
+    bench_reduce<dbr_short_t>(report, "short", DBR_SHORT, elements, rounds, agree);
+    bench_reduce<dbr_enum_t>(report, "enum", DBR_ENUM, elements, rounds, agree);
+    bench_reduce<dbr_char_t>(report, "char", DBR_CHAR, elements, rounds, agree);
+    report.write(json);
+    if (!agree) {
+        std::cerr << "SIMD results differ from the scalar kernel" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,232 @@
+/**
+ * @file benchEpicsProxy.cpp
+ * @brief Benchmarks for the read, write, monitor, connect and lookup paths of EpicsProxy.
+ *
+ * Runs against a local softIoc started with bench/run_softioc.sh, or against the
+ * in-process simulated transport with --sim to measure the library's own overhead, or over
+ * pvAccess with --pva (built with make PVA=1) against softIocPVA to compare with CA.
+ * Usage: benchEpicsProxy [--sim] [--pva] [--prefix P] [--iterations N] [--pvs N] [--json FILE]
+ */
+
+#include <atomic>
+#include <cstdlib>
+#include <memory_resource>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "EpicsProxy.h"
+#include "benchUtil.h"
+
+using namespace epics;
+
+static const std::vector<int> arraySizes = {16, 256, 4096, 65536, 1048576};
+static std::atomic<unsigned long> monitorEvents{0};
+
+static void count_event(struct event_handler_args args) {
+    if (args.status == ECA_NORMAL) {
+        monitorEvents++;
+    }
+}
+
+int main(int argc, char** argv) {
+    bool sim = false;
+    bool pva = false;
+    std::string prefix = "bench:";
+    std::string json;
+    int iterations = 1000;
+    int pvCount = 1000;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--sim") {
+            sim = true;
+        } else if (arg == "--pva") {
+            pva = true;
+        } else if (arg == "--prefix" && i + 1 < argc) {
+            prefix = argv[++i];
+        } else if (arg == "--iterations" && i + 1 < argc) {
+            iterations = std::atoi(argv[++i]);
+        } else if (arg == "--pvs" && i + 1 < argc) {
+            pvCount = std::atoi(argv[++i]);
+        } else if (arg == "--json" && i + 1 < argc) {
+            json = argv[++i];
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--sim] [--pva] [--prefix P] [--iterations N] [--pvs N] [--json FILE]" << std::endl;
+            return 2;
+        }
+    }
+
+    try {
+        //Loopback only, so runs are comparable between machines and releases
+        struct caConfig conf;
+        conf.ca_addr_list = "127.0.0.1";
+        conf.ca_auto_addr_list = "NO";
+        conf.ca_conn_tmo = "30.0";
+        conf.ca_beacon_period = "15.0";
+        conf.ca_repeater_port = "5065";
+        conf.ca_server_port = "5064";
+        conf.ca_max_array_bytes = "10000000";
+        conf.ts_min_west = "360";
+
+        caSimTransport simTransport;
+        if (sim) {
+            for (int size : arraySizes) {
+                simTransport.add_pv(prefix + "wf" + std::to_string(size), DBR_DOUBLE, size, 1.0);
+            }
+            conf.transport = &simTransport;
+        }
+#ifdef EPICS_PROXY_WITH_PVA
+        caPvaTransport pvaTransport;
+        if (pva && !sim) {
+            conf.transport = &pvaTransport;
+        }
+#else
+        if (pva) {
+            std::cerr << "Built without pvAccess support, rebuild with make PVA=1" << std::endl;
+            return 2;
+        }
+#endif
+
+        bench::report report("EpicsProxy");
+        report.set_config("transport", sim ? "sim" : (pva ? "pva" : "ca"));
+        report.set_config("prefix", prefix);
+        report.set_config("iterations", std::to_string(iterations));
+        report.set_config("pvs", std::to_string(pvCount));
+
+        std::vector<std::string> names = {"ao"};
+        for (int size : arraySizes) {
+            names.push_back("wf" + std::to_string(size));
+        }
+        for (int i = 0; i < pvCount; i++) {
+            names.push_back("ai" + std::to_string(i));
+        }
+
+        //Connect: init issues every search, then waits for the connection handlers of all channels
+        EpicsProxy proxy("bench");
+        auto start = bench::clock::now();
+        proxy.init(prefix, names, conf);
+        double connect_us = bench::elapsed_us(start, bench::clock::now());
+        report.add("connect", {{"pvs", static_cast<double>(names.size())},
+                               {"total_ms", connect_us / 1000.0},
+                               {"per_pv_us", connect_us / names.size()}});
+
+        std::vector<double> samples;
+        for (int i = 0; i < iterations; i++) {
+            auto t0 = bench::clock::now();
+            proxy.read_pv<double>("ao");
+            samples.push_back(bench::elapsed_us(t0, bench::clock::now()));
+        }
+        report.add("scalar_get", bench::summarize(samples));
+
+        samples.clear();
+        for (int i = 0; i < iterations; i++) {
+            auto t0 = bench::clock::now();
+            proxy.write_pv<double>("ao", static_cast<double>(i));
+            samples.push_back(bench::elapsed_us(t0, bench::clock::now()));
+        }
+        report.add("scalar_put", bench::summarize(samples));
+
+        for (int size : arraySizes) {
+            std::string name = "wf" + std::to_string(size);
+            int rounds = std::max(10, iterations * 16 / size);
+            samples.clear();
+            for (int i = 0; i < rounds; i++) {
+                auto t0 = bench::clock::now();
+                proxy.read_pv_array<double>(name);
+                samples.push_back(bench::elapsed_us(t0, bench::clock::now()));
+            }
+            double total_us = 0.0;
+            for (double sample : samples) {
+                total_us += sample;
+            }
+            auto metrics = bench::summarize(samples);
+            metrics.push_back({"elements", static_cast<double>(size)});
+            metrics.push_back({"mb_per_s", rounds * size * sizeof(double) / total_us});
+            report.add("array_get_" + std::to_string(size), metrics);
+
+            //Same array with the IOC sending DBR_FLOAT, half the bytes
+            samples.clear();
+            for (int i = 0; i < rounds; i++) {
+                auto t0 = bench::clock::now();
+                proxy.read_pv_array_as<double>(name, DBR_FLOAT);
+                samples.push_back(bench::elapsed_us(t0, bench::clock::now()));
+            }
+            total_us = 0.0;
+            for (double sample : samples) {
+                total_us += sample;
+            }
+            metrics = bench::summarize(samples);
+            metrics.push_back({"elements", static_cast<double>(size)});
+            metrics.push_back({"mb_per_s", rounds * size * sizeof(float) / total_us});
+            report.add("array_get_float_" + std::to_string(size), metrics);
+
+            //Same array into an arena released every round, with no global heap traffic
+            std::vector<char> arena(size * sizeof(double) + 4096);
+            samples.clear();
+            for (int i = 0; i < rounds; i++) {
+                std::pmr::monotonic_buffer_resource cycle(arena.data(), arena.size());
+                auto t0 = bench::clock::now();
+                proxy.read_pv_array<double>(name, &cycle);
+                samples.push_back(bench::elapsed_us(t0, bench::clock::now()));
+            }
+            total_us = 0.0;
+            for (double sample : samples) {
+                total_us += sample;
+            }
+            metrics = bench::summarize(samples);
+            metrics.push_back({"elements", static_cast<double>(size)});
+            metrics.push_back({"mb_per_s", rounds * size * sizeof(double) / total_us});
+            report.add("array_get_pmr_" + std::to_string(size), metrics);
+        }
+
+        //Monitor rate: buffered puts to a monitored record, counting delivered events
+        proxy.add_monitor("ao", &proxy, count_event);
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        monitorEvents = 0;
+        flushPolicy policy;
+        policy.max_count = 64;
+        proxy.set_buffered_writes(true, policy);
+        int puts = iterations * 10;
+        start = bench::clock::now();
+        for (int i = 0; i < puts; i++) {
+            proxy.write_pv<double>("ao", static_cast<double>(iterations + i));
+        }
+        proxy.flush();
+        //Wait for the tail of the event stream to drain
+        unsigned long seen = 0;
+        auto last_change = bench::clock::now();
+        while (bench::elapsed_us(last_change, bench::clock::now()) < 200000.0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            if (monitorEvents != seen) {
+                seen = monitorEvents;
+                last_change = bench::clock::now();
+            }
+        }
+        double monitor_s = bench::elapsed_us(start, last_change) / 1e6;
+        proxy.set_buffered_writes(false);
+        proxy.remove_monitor("ao");
+        report.add("monitor", {{"puts", static_cast<double>(puts)},
+                               {"events", static_cast<double>(seen)},
+                               {"events_per_s", seen / monitor_s}});
+
+        //Lookup cost of the first and the last registered name
+        for (std::string name : {names.front(), names.back()}) {
+            int rounds = iterations * 100;
+            start = bench::clock::now();
+            for (int i = 0; i < rounds; i++) {
+                if (proxy.get_pv(name) == nullptr) {
+                    return 1;
+                }
+            }
+            report.add(name == names.front() ? "lookup_first" : "lookup_last",
+                       {{"pvs", static_cast<double>(names.size())},
+                        {"ns_per_lookup", bench::elapsed_us(start, bench::clock::now()) * 1000.0 / rounds}});
+        }
+
+        report.write(json);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
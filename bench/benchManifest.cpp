@@ -0,0 +1,108 @@
+/**
+ * @file benchManifest.cpp
+ * @brief Startup time of EpicsProxy::load_manifest per phase, for tens of thousands of PVs.
+ *
+ * Writes a manifest of N ai records and loads it. Runs against a local softIoc started
+ * with bench/run_softioc.sh P N, or against the simulated transport with --sim.
+ * Usage: benchManifest [--sim] [--prefix P] [--pvs N] [--timeout S] [--json FILE]
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+
+#include <unistd.h>
+
+#include "EpicsProxy.h"
+#include "benchUtil.h"
+
+using namespace epics;
+
+int main(int argc, char** argv) {
+    bool sim = false;
+    std::string prefix = "bench:";
+    std::string json;
+    int pvCount = 50000;
+    double timeout = 30.0;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--sim") {
+            sim = true;
+        } else if (arg == "--prefix" && i + 1 < argc) {
+            prefix = argv[++i];
+        } else if (arg == "--pvs" && i + 1 < argc) {
+            pvCount = std::atoi(argv[++i]);
+        } else if (arg == "--timeout" && i + 1 < argc) {
+            timeout = std::atof(argv[++i]);
+        } else if (arg == "--json" && i + 1 < argc) {
+            json = argv[++i];
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--sim] [--prefix P] [--pvs N] [--timeout S] [--json FILE]" << std::endl;
+            return 2;
+        }
+    }
+
+    std::string path = "/tmp/benchManifest." + std::to_string(getpid()) + ".txt";
+    try {
+        {
+            std::ofstream manifest(path);
+            manifest << "# benchManifest: " << pvCount << " ai records\n";
+            for (int i = 0; i < pvCount; i++) {
+                manifest << "ai" << i << " double\n";
+            }
+        }
+
+        struct caConfig conf;
+        conf.ca_addr_list = "127.0.0.1";
+        conf.ca_auto_addr_list = "NO";
+        conf.ca_conn_tmo = "30.0";
+        conf.ca_beacon_period = "15.0";
+        conf.ca_repeater_port = "5065";
+        conf.ca_server_port = "5064";
+        conf.ca_max_array_bytes = "10000000";
+        conf.ts_min_west = "360";
+        caSimTransport simTransport;
+        if (sim) {
+            conf.transport = &simTransport;
+        }
+
+        bench::report report("Manifest");
+        report.set_config("transport", sim ? "sim" : "ca");
+        report.set_config("prefix", prefix);
+        report.set_config("pvs", std::to_string(pvCount));
+
+        EpicsProxy proxy("bench");
+        proxy.init(prefix, {}, conf);
+        auto start = bench::clock::now();
+        manifestReport result = proxy.load_manifest(path, timeout);
+        double total_ms = bench::elapsed_us(start, bench::clock::now()) / 1000.0;
+        report.add("load_manifest", {{"pvs", static_cast<double>(result.pvs)},
+                                     {"parse_ms", result.parse_ms},
+                                     {"create_ms", result.create_ms},
+                                     {"flush_ms", result.flush_ms},
+                                     {"searches_issued_ms", result.parse_ms + result.create_ms + result.flush_ms},
+                                     {"connect_ms", result.connect_ms},
+                                     {"total_ms", total_ms},
+                                     {"connected", static_cast<double>(result.connected)},
+                                     {"type_mismatches", static_cast<double>(result.type_mismatches.size())}});
+
+        std::string last = "ai" + std::to_string(pvCount - 1);
+        int rounds = 100000;
+        start = bench::clock::now();
+        for (int i = 0; i < rounds; i++) {
+            if (proxy.get_pv(last) == nullptr) {
+                return 1;
+            }
+        }
+        report.add("lookup_last", {{"pvs", static_cast<double>(pvCount)},
+                                   {"ns_per_lookup", bench::elapsed_us(start, bench::clock::now()) * 1000.0 / rounds}});
+        report.write(json);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        std::remove(path.c_str());
+        return 1;
+    }
+    std::remove(path.c_str());
+    return 0;
+}
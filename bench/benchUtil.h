@@ -0,0 +1,102 @@
+#ifndef BENCHUTIL_H
+#define BENCHUTIL_H
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace bench {
+
+typedef std::chrono::steady_clock clock;
+
+inline double elapsed_us(clock::time_point start, clock::time_point end) {
+    return std::chrono::duration<double, std::micro>(end - start).count();
+}
+
+//Summary of per-operation latencies in microseconds
+inline std::vector<std::pair<std::string, double>> summarize(std::vector<double> samples) {
+    if (samples.empty()) {
+        return {};
+    }
+    std::sort(samples.begin(), samples.end());
+    double sum = 0.0;
+    for (double sample : samples) {
+        sum += sample;
+    }
+    auto percentile = [&](double p) {return samples[static_cast<std::size_t>(p * (samples.size() - 1))];};
+    return {{"iterations", static_cast<double>(samples.size())},
+            {"mean_us", sum / samples.size()},
+            {"min_us", samples.front()},
+            {"p50_us", percentile(0.50)},
+            {"p99_us", percentile(0.99)},
+            {"max_us", samples.back()}};
+}
+
+/*
+Collects benchmark results and writes them as one JSON document:
+{"suite": ..., "config": {...}, "results": [{"name": ..., <metric>: <number>, ...}, ...]}
+*/
+class report {
+    private:
+    std::string suite;
+    std::vector<std::pair<std::string, std::string>> config;
+    std::vector<std::pair<std::string, std::vector<std::pair<std::string, double>>>> results;
+
+    static std::string quote(const std::string& text) {
+        std::string out = "\"";
+        for (char c : text) {
+            if (c == '"' || c == '\\') {
+                out += '\\';
+            }
+            out += c;
+        }
+        return out + "\"";
+    }
+
+    public:
+    report(std::string m_suite) : suite(m_suite) {}
+
+    void set_config(std::string key, std::string value) {config.push_back({key, value});}
+
+    void add(std::string name, std::vector<std::pair<std::string, double>> metrics) {
+        results.push_back({name, metrics});
+        //Progress on stderr so stdout stays valid JSON
+        std::cerr << name;
+        for (auto& metric : metrics) {
+            std::cerr << " " << metric.first << "=" << metric.second;
+        }
+        std::cerr << std::endl;
+    }
+
+    void write(std::ostream& out) {
+        out << "{\"suite\": " << quote(suite) << ", \"config\": {";
+        for (std::size_t i = 0; i < config.size(); i++) {
+            out << (i ? ", " : "") << quote(config[i].first) << ": " << quote(config[i].second);
+        }
+        out << "}, \"results\": [";
+        for (std::size_t i = 0; i < results.size(); i++) {
+            out << (i ? ",\n  " : "\n  ") << "{\"name\": " << quote(results[i].first);
+            for (auto& metric : results[i].second) {
+                out << ", " << quote(metric.first) << ": " << metric.second;
+            }
+            out << "}";
+        }
+        out << "\n]}" << std::endl;
+    }
+
+    //Write to path, or to stdout when path is empty
+    void write(std::string path) {
+        if (path.empty()) {
+            write(std::cout);
+            return;
+        }
+        std::ofstream file(path);
+        write(file);
+    }
+};
+} // namespace bench
+#endif
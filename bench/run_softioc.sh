@@ -0,0 +1,24 @@
+#!/bin/sh
+# Start a softIoc on loopback with the records benchEpicsProxy expects.
+# Usage: bench/run_softioc.sh [prefix] [ai_count]
+# Set SOFTIOC=softIocPVA to serve the same records over pvAccess as well.
+PREFIX=${1:-bench:}
+COUNT=${2:-1000}
+DB=$(mktemp /tmp/benchEpicsProxy.XXXXXX.db)
+
+{
+    echo "record(ao, \"${PREFIX}ao\") { field(PREC, \"3\") }"
+    for n in 16 256 4096 65536 1048576; do
+        echo "record(waveform, \"${PREFIX}wf$n\") { field(FTVL, \"DOUBLE\") field(NELM, \"$n\") }"
+    done
+    i=0
+    while [ $i -lt $COUNT ]; do
+        echo "record(ai, \"${PREFIX}ai$i\") { field(VAL, \"$i\") }"
+        i=$((i + 1))
+    done
+} > "$DB"
+
+export EPICS_CA_ADDR_LIST=127.0.0.1
+export EPICS_CA_AUTO_ADDR_LIST=NO
+export EPICS_CA_MAX_ARRAY_BYTES=10000000
+exec ${SOFTIOC:-softIoc} -d "$DB"
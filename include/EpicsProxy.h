@@ -8,12 +8,36 @@
 #include <iostream>
 #include <sstream>
 #include <algorithm>
+#include <string_view>
+#include <unordered_map>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <array>
+#include <tuple>
+#include <memory_resource>
 
 #include <cadef.h>
 #include <db_access.h>
 #include <cstdarg>
 
 #include "PV.h"
+#include "caTransport.h"
+#include "caSimTransport.h"
+#include "caPvaTransport.h"
+#include "caWriteBuffer.h"
+#include "caRecorder.h"
+#include "caReplay.h"
+#include "caLatency.h"
+#include "caTrace.h"
+#include "caStats.h"
+#include "caManifest.h"
+#include "caPVPool.h"
+#include "caChannelTable.h"
+#include "caRecord.h"
+#include "caSnapshot.h"
+#include "TypedPV.h"
+#include "caImage.h"
 //This is an attempt to redefine SEVCHK so that it prints to the error variable. It doesn't work.
 /*
 #define SEVCHK(CODE, MSG) \
@@ -28,6 +52,37 @@
 
 namespace epics {
 
+//Latency histograms of one PV, indexed by latencyOp
+struct pvLatency {
+    std::string name;
+    latencySnapshot ops[LATENCY_OP_COUNT];
+};
+
+//Counters of one PV
+struct pvStats {
+    std::string name;
+    counterSnapshot counters;
+};
+
+//Counters of every PV and their sum
+struct proxyStats {
+    counterSnapshot total;
+    std::vector<pvStats> pvs;
+};
+
+//Outcome and per-phase timing of EpicsProxy::load_manifest
+struct manifestReport {
+    std::size_t pvs = 0;
+    std::size_t duplicates = 0;         //Repeated names skipped in the manifest
+    std::size_t connected = 0;
+    double parse_ms = 0.0;              //Reading and interning the manifest
+    double create_ms = 0.0;             //Constructing PVs and issuing ca_create_channel
+    double flush_ms = 0.0;              //Sending the search requests
+    double connect_ms = 0.0;            //Waiting for connections
+    std::vector<std::string> not_connected;
+    std::vector<std::string> type_mismatches;   //Connected with a native type other than the manifest's
+};
+
 struct caConfig {
     const char* ca_addr_list;
     const char* ca_auto_addr_list;
@@ -37,18 +92,23 @@ struct caConfig {
     const char* ca_server_port;
     const char* ca_max_array_bytes;
     const char* ts_min_west;
+    caTransport* transport = nullptr;   //Channel Access when null, or e.g. a caSimTransport (not owned)
+    bool lazy_channels = false;         //Create each channel on first use instead of in init
 };
 
 class caContext {
     private:
     struct ca_client_context* context = nullptr;
     public:
-    caContext() {
-        SEVCHK(ca_context_create(ca_enable_preemptive_callback), "Failed to create EPICS context");
-        context = ca_current_context();
+    //Throws if another live context uses a different transport
+    caContext(caTransport* m_transport = nullptr) {
+        bind_transport(m_transport);
+        SEVCHK(get_transport()->context_create(ca_enable_preemptive_callback), "Failed to create EPICS context");
+        context = get_transport()->current_context();
     }
     ~caContext() {
-        ca_context_destroy();
+        get_transport()->context_destroy();
+        unbind_transport();
     }
     struct ca_client_context* get_context() {return context;};
 };
@@ -57,9 +117,19 @@ class EpicsProxy {
     //Class Variables
 private:
     caContext* caContext_ptr = nullptr;
+    caWriteBuffer* writeBuffer_ptr = nullptr;
+    caRecorder* recorder_ptr = nullptr;
+    caReplay* replay_ptr = nullptr;
+    caTracingTransport* tracingTransport_ptr = nullptr;  //Not owned; see caTracingTransport::wrap
+    paddedCounter unattributedExceptions;     //CA exceptions without a channel
     std::string error;
     std::string deviceName;
     std::vector<PV*> pvList;
+    std::unordered_map<std::string_view, PV*> pvIndex;      //Field name to PV; keys view the PV's own name
+    std::vector<caPVPool*> pvPools;
+    bool lazyChannels = false;
+    std::thread prewarmThread;
+    std::atomic<bool> prewarmStop{false};
     std::string statusPV;
     unsigned long currentStatus = 0x1;
     std::string axisName;
@@ -71,6 +141,11 @@ private:
                                         DBR_STRING,
                                         DBR_LONG};
 
+    void _add_pv(PV* m_pv);
+    void _wait_connected(std::size_t m_first, const char* m_message);
+    void _create_group(std::string m_recordName, const char* const* m_fields, std::size_t m_count, PV** m_pvs);
+    void _snapshot(snapshotRequest* m_requests, std::size_t m_count);
+
 public:
     //Constructor and destructor
     EpicsProxy(std::string name);
@@ -86,6 +161,42 @@ public:
     // Create PVs
     PV* create_PV(std::string m_fullName);
 
+    //Look up a PV by field name, throws if it does not exist
+    PV* get_pv(std::string m_fieldName);
+
+    //Typed handle to a PV; throws if its native type does not fit TypeValue exactly
+    template<typename TypeValue>
+    TypedPV<TypeValue> get_typed_pv(std::string m_fieldName) {return TypedPV<TypeValue>(get_pv(m_fieldName));}
+
+    //Bulk-create the PVs of a manifest file after init. Channels are created in one pass and
+    //searched with a single flush; with m_timeout > 0 the call waits that long for connections.
+    manifestReport load_manifest(std::string m_path, double m_timeout = 5.0);
+
+    //Create the PVs of one record, m_recordName being relative to the device name, e.g.
+    //create_record<Motor>("m1") for sans:m1.VAL, sans:m1.RBV and so on. The PVs are owned
+    //by the proxy and can also be reached by name, as get_pv("m1.RBV").
+    template<typename Record>
+    caRecord<Record> create_record(std::string m_recordName) {
+        typedef typename caRecord<Record>::fields fields;
+        std::array<PV*, fields::size> m_pvs;
+        _create_group(m_recordName, fields::names.data(), fields::size, m_pvs.data());
+        return caRecord<Record>(m_recordName, m_pvs);
+    }
+
+    //Bind an areaDetector NDStdArrays plugin, m_pluginName being relative to the device
+    //name, e.g. create_image("image1:") for 13SIM1:image1:ArrayData and its shape PVs
+    caImage create_image(std::string m_pluginName);
+
+    //In lazy mode, create the channels not yet used from a background thread at a bounded
+    //rate, so searches trickle out instead of arriving as one storm
+    void start_prewarm(double m_channelsPerSecond = 1000.0);
+    void stop_prewarm();
+    bool get_lazy_channels() {return lazyChannels;};
+    std::size_t get_created_channels();
+
+    //Counts CA exceptions against their PV, then reports them like the default handler
+    static void exception_callback(struct exception_handler_args args);
+
     //Access functions
     std::string get_device_name() {return deviceName;};
     std::string get_axis_name() {return axisName;};
@@ -96,8 +207,65 @@ public:
     struct ca_client_context* get_context() {return caContext_ptr->get_context();};
     void destroy_context() {delete caContext_ptr;};
 
+    //Buffered (fire-and-forget) writes
+    void set_buffered_writes(bool enable, flushPolicy m_policy = flushPolicy());
+    bool get_buffered_writes() {return writeBuffer_ptr != nullptr;};
+    void flush();
+
+    //Coalescing writes per PV
+    void set_coalescing(std::string m_fieldName, bool enable);
+    coalescingCounters get_coalescing_counters(std::string m_fieldName);
+
+    //Read (and, with offset and data records, write) large arrays in pieces of at most
+    //m_config.chunk_bytes, see caChunkedArray
+    void set_chunking(std::string m_fieldName, bool enable, chunkConfig m_config = chunkConfig());
+
+    //Record monitor events of the given PVs into a memory-mapped ring file of capacity records.
+    //Returns the fields that were not connected and so are not being recorded; they keep
+    //their place in the name table and can be added later with get_recorder()->add.
+    std::vector<std::string> start_recorder(std::string m_path, std::vector<std::string> m_fieldNames, std::size_t m_capacity);
+    void stop_recorder();
+    caRecorder* get_recorder() {return recorder_ptr;};
+
+    //Route add_monitor/remove_monitor to a replay source instead of the IOC (not owned, nullptr for live)
+    void set_replay_source(caReplay* m_replay) {replay_ptr = m_replay;};
+    caReplay* get_replay_source() {return replay_ptr;};
+
+    //Record spans of PV operations and CA calls; stop_trace writes them as Chrome trace JSON
+    void start_trace(std::size_t m_perThreadEvents = 65536);
+    std::size_t stop_trace(std::string m_path);
+
+    //Cumulative operation counters per PV and in aggregate
+    proxyStats stats();
+
+    //Snapshot the latency histograms of every PV
+    std::vector<pvLatency> latency_snapshot();
+
+    //Fill every member bound by Struct's EPICS_SNAPSHOT_FIELDS from one batch of gets and a
+    //single ca_pend_io. Each get requests the DBR_TIME_ type of its member's C++ type, so the
+    //IOC converts and bound timestamp members receive the record's time.
+    template<typename Struct>
+    void snapshot(Struct& m_struct) {
+        auto m_fields = Struct::snapshot_fields();
+        std::array<snapshotRequest, std::tuple_size_v<decltype(m_fields)>> m_requests;
+        std::size_t i = 0;
+        std::apply([&](auto&... m_field) {
+            ((m_requests[i].pv = get_pv(m_field.field),
+              m_requests[i].type = snapshotType<std::remove_cvref_t<decltype(m_struct.*m_field.member)>>::type,
+              i++), ...);
+        }, m_fields);
+        _snapshot(m_requests.data(), m_requests.size());
+        i = 0;
+        std::apply([&](auto&... m_field) {
+            (snapshot_unpack(m_struct, m_field, m_requests[i++]), ...);
+        }, m_fields);
+    }
 
     void add_monitor(std::string m_fieldName, EpicsProxy* proxy, void (*callback)(struct event_handler_args args));
+    //Whole-array monitor read through a triple buffer, see PV::add_array_monitor. Live IOC only.
+    caTripleBuffer* add_array_monitor(std::string m_fieldName);
+    //Whole-array monitor reduced to min, max, mean, sum and centroid on the CA thread. Live IOC only.
+    caReduction* add_reduction(std::string m_fieldName, reductionCallback* m_callback = nullptr, void* m_usr = nullptr);
     void remove_monitor(std::string m_fieldName);
 
     //Read and write functions
@@ -122,6 +290,25 @@ public:
     template<typename TypeValue>
     std::vector<TypeValue> read_pv_array(std::string m_fieldName);
 
+    //Array read converted by the IOC to m_type, e.g. DBR_FLOAT for half the bytes of DBR_DOUBLE
+    template<typename TypeValue>
+    std::vector<TypeValue> read_pv_array_as(std::string m_fieldName, chtype m_type);
+
+    //Array reads allocating from m_resource instead of the global heap
+    template<typename TypeValue>
+    std::pmr::vector<TypeValue> read_pv_array(std::string m_fieldName, std::pmr::memory_resource* m_resource);
+    template<typename TypeValue>
+    std::pmr::vector<TypeValue> read_pv_array_as(std::string m_fieldName, chtype m_type, std::pmr::memory_resource* m_resource);
+
+    //Request type of array reads and monitors of one PV (TYPENOTCONN for native)
+    void set_wire_type(std::string m_fieldName, chtype m_type);
+    void set_reduced_precision(std::string m_fieldName, bool enable);
+    //Array reads and monitors of the PV transfer only the valid elements, see PV::set_dynamic_size
+    void set_dynamic_size(std::string m_fieldName, bool enable);
+
+    //Array read as m_scale * value + m_offset, converted with SIMD kernels
+    std::vector<double> read_pv_array_scaled(std::string m_fieldName, double m_scale, double m_offset = 0.0);
+
 };
 }
 #endif
\ No newline at end of file
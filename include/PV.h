@@ -6,10 +6,25 @@
 #include <any>
 #include <stdexcept>
 #include <iostream>
+#include <atomic>
+#include <mutex>
+#include <memory_resource>
 
 #include <cadef.h>
 #include <db_access.h>
 
+#include "caTransport.h"
+#include "caWriteBuffer.h"
+#include "caCoalescingWriter.h"
+#include "caLatency.h"
+#include "caTrace.h"
+#include "caStats.h"
+#include "caChannelTable.h"
+#include "caConvert.h"
+#include "caChunkedArray.h"
+#include "caTripleBuffer.h"
+#include "caReduction.h"
+
 namespace epics {
 
 class EpicsProxy;
@@ -20,15 +35,64 @@ class PV {
     std::string deviceName;
     std::string fieldName;
     std::string pvName;
-    std::vector<evid> monitors;
+    unsigned priority = 20;
+    chtype wireType = TYPENOTCONN;      //Requested by array reads and monitors; native when TYPENOTCONN
+    bool dynamicSize = false;           //Array reads and monitors request count 0 (NORD elements)
+    bool lazy = false;
+    std::once_flag channelOnce;
+    std::atomic<bool> channelCreated{false};
+    //A monitor subscription. The channel table calls PV::monitor_callback, which times the
+    //event and forwards it to the user callback with the user's argument restored.
+    struct monitorHook {
+        PV* pv;
+        void (*callback)(struct event_handler_args args);
+        void* usr;
+        std::atomic<uint64_t> lastEvent{0};
+        sharedSubscription* subscription;
+    };
+
+    std::vector<monitorHook*> monitors;
+    //A full-length array monitor publishing each event into a triple buffer
+    struct frameHook {
+        PV* pv;
+        caTripleBuffer* frames;
+        sharedSubscription* subscription;
+    };
+    std::vector<frameHook*> frameMonitors;
+    //A whole-array monitor reduced to statistics in the callback
+    struct reductionHook {
+        PV* pv;
+        caReduction* reduction;
+        sharedSubscription* subscription;
+    };
+    std::vector<reductionHook*> reductionMonitors;
+    sharedChannel* shared = nullptr;    //Entry in the process-wide channel table
     chid channel;
+    std::atomic<bool> connected{false};
+    std::atomic<bool> everConnected{false};
+    uint64_t createdAt = 0;
+    caLatencyStats latency;
+    caCounters counters;
+    caWriteBuffer* writeBuffer = nullptr;
+    caCoalescingWriter* coalescer = nullptr;
+    caChunkedArray* chunker = nullptr;
     //void* puser;
 
     friend class EpicsProxy;
+    template<typename> friend class TypedPV;
     
     //Create and destroy channel
     void _create_channel(bool pend);
+    void _ensure_channel(bool m_wait);
     void _clear_channel();
+    void _retire_coalescer();
+    int _pend_io(std::string m_message);
+    int _fetch_array(chtype m_type, unsigned long m_count, void* m_dest);
+    unsigned long _get_dynamic(chtype m_type, std::vector<char>& m_wire, int& m_status);
+    static void connection_state(void* usr, bool m_connected);
+    static void monitor_callback(struct event_handler_args args);
+    static void frame_callback(struct event_handler_args args);
+    static void reduction_callback(struct event_handler_args args);
 
     //PV Status
     chtype get_field_type();
@@ -38,8 +102,10 @@ class PV {
     TypeValue _get();
     std::string _get_string();
 
-    template<typename TypeValue>
-    std::vector<TypeValue> _get_array();
+    template<typename TypeValue, typename Alloc = std::allocator<TypeValue>>
+    std::vector<TypeValue, Alloc> _get_array(chtype m_type, const Alloc& m_alloc = Alloc());
+    std::vector<double> _get_array_scaled(chtype m_type, double m_scale, double m_offset);
+    chtype _wire_type();
 
     //Writing PVs
     template<typename TypeValue>
@@ -48,15 +114,48 @@ class PV {
 
     template<typename TypeValue>
     void _put_array(std::vector<TypeValue> value);
+    int _complete_put(chtype field_type, unsigned long count, uint64_t start);
 
     public:
     PV(std::string m_deviceName, std::string m_fieldName);
+    PV(std::string m_deviceName, std::string m_fieldName, unsigned m_priority, bool m_lazy = false);
     ~PV();
     
     std::string get_name() {return fieldName;};
-    chtype get_data_type() {return ca_field_type(channel);};
-    chid get_channel() {return channel;};
+    std::string get_full_name() {return pvName;};
+    chtype get_data_type() {_ensure_channel(true); return get_transport()->field_type(channel);};
+    chid get_channel() {_ensure_channel(true); return channel;};
+    sharedChannel* get_shared_channel() {_ensure_channel(true); return shared;};
     std::string get_error() {return error;};
+    bool is_connected() {return connected;};
+    //Lazy PVs create their channel on first use; prewarm creates it without waiting
+    bool is_lazy() {return lazy;};
+    bool has_channel() {return channelCreated;};
+    void prewarm() {_ensure_channel(false);};
+    //Wait up to timeout seconds for the channel to connect
+    bool wait_connected(double timeout);
+
+    //Latency histogram snapshot for one operation type
+    latencySnapshot get_latency(latencyOp op) {return latency.snapshot(op);};
+
+    //Cumulative operation counters
+    counterSnapshot get_counters() {return counters.snapshot();};
+    //Count a CA exception reported for this channel
+    void count_exception() {counters.exceptions.add();};
+
+    //Buffered writes. With a write buffer set, puts are queued without ca_pend_io
+    void set_write_buffer(caWriteBuffer* m_writeBuffer);
+    caWriteBuffer* get_write_buffer() {return writeBuffer;};
+
+    //Coalescing writes. At most one put is in flight and only the newest pending value is kept
+    void set_coalescing(bool enable);
+    bool get_coalescing() {return coalescer != nullptr;};
+    coalescingCounters get_coalescing_counters();
+
+    //Chunked arrays. Array reads and writes larger than m_config.chunk_bytes are split into
+    //pieces that fit in one CA message, with several pieces in flight
+    void set_chunking(bool enable, chunkConfig m_config = chunkConfig());
+    bool get_chunking() {return chunker != nullptr;};
     
     //Cleanup
     void clear_channel();
@@ -70,6 +169,32 @@ class PV {
     template<typename TypeValue>
     std::vector<TypeValue> read_array();
 
+    //Read with the IOC converting to m_type, widened to TypeValue on the client
+    template<typename TypeValue>
+    std::vector<TypeValue> read_array_as(chtype m_type);
+
+    //As above, with the result and the transfer buffer allocated from m_resource, e.g. a
+    //std::pmr::monotonic_buffer_resource released once per control cycle
+    template<typename TypeValue>
+    std::pmr::vector<TypeValue> read_array(std::pmr::memory_resource* m_resource);
+    template<typename TypeValue>
+    std::pmr::vector<TypeValue> read_array_as(chtype m_type, std::pmr::memory_resource* m_resource);
+
+    //Read as m_scale * value + m_offset (e.g. raw counts to EGU), converted with the SIMD
+    //kernels of caConvert straight from the CA buffer
+    std::vector<double> read_array_scaled(double m_scale, double m_offset);
+
+    //DBR type requested by read_array and monitors, TYPENOTCONN for the native type
+    void set_wire_type(chtype m_type);
+    chtype get_wire_type() {return wireType;};
+    //Dynamic size: array reads and monitors ask for count 0, so the IOC sends only the valid
+    //elements (NORD of a waveform) and read_array returns that many. Needs CA 4.13 or later.
+    void set_dynamic_size(bool enable) {dynamicSize = enable;};
+    bool get_dynamic_size() {return dynamicSize;};
+    //Request DBR_FLOAT for DBR_DOUBLE and DBR_SHORT for DBR_LONG fields, halving the bytes
+    //on the wire. Values lose precision, and DBR_LONG values must fit in 16 bits.
+    void set_reduced_precision(bool enable);
+
     //Write PVs
     template<typename TypeValue>
     void write(TypeValue newValue);
@@ -81,6 +206,13 @@ class PV {
     chtype get_dbr_type(std::string type_name);
 
     void add_monitor(EpicsProxy* proxy, void (*callback)(struct event_handler_args args));
+    //Monitor the whole array (the valid elements with dynamic size) into a triple buffer
+    //owned by the PV until remove_monitor. One reader thread takes the newest frame with
+    //latest() and reads it in place, never blocking or blocked by the CA thread.
+    caTripleBuffer* add_array_monitor();
+    //Monitor the whole array and keep only its statistics, computed on the CA thread. The
+    //stage is owned by the PV until remove_monitor; m_callback, if set, gets every result.
+    caReduction* add_reduction(reductionCallback* m_callback = nullptr, void* m_usr = nullptr);
     void remove_monitor();
 };
 } // namespace epics
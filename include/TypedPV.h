@@ -0,0 +1,70 @@
+#ifndef TYPEDPV_H
+#define TYPEDPV_H
+
+#include <string>
+#include <vector>
+#include <memory>
+
+#include <cadef.h>
+#include <db_access.h>
+
+#include "PV.h"
+
+namespace epics {
+
+/*
+Handle to a PV with a fixed C++ value type. The native type is checked once, when the
+handle is made: a native type that TypeValue holds exactly is requested as is and
+widened on the client through a conversion chosen then, and one that would lose
+precision or range is rejected. Reads and monitors then go straight to CA with no type
+lookup per call. Writes send TypeValue's own DBR type and the IOC converts.
+The handle does not own the PV and must be destroyed before the proxy that does.
+Allowed types: double, float, int, short, char, long and std::string.
+*/
+template<typename TypeValue>
+class TypedPV {
+    public:
+    typedef void (*typedCallback)(TypeValue m_value, void* usr);
+    typedef void (*convertFunc)(const void* m_wire, TypeValue* m_out, unsigned long m_count);
+
+    private:
+    struct typedHook {
+        PV* pv;
+        convertFunc convert;
+        typedCallback callback;
+        void* usr;
+        sharedSubscription* subscription;
+    };
+
+    PV* pv = nullptr;
+    chtype readType = DBR_DOUBLE;       //Requested by reads and monitors
+    chtype writeType = DBR_DOUBLE;      //Sent by writes
+    unsigned long elementCount = 1;
+    convertFunc convert = nullptr;
+    std::vector<std::unique_ptr<typedHook>> monitors;
+
+    static void monitor_callback(struct event_handler_args args);
+
+    public:
+    TypedPV(PV* m_pv);
+    ~TypedPV();
+    TypedPV(TypedPV&&) = default;
+    TypedPV& operator=(TypedPV&&) = default;
+    TypedPV(const TypedPV&) = delete;
+    TypedPV& operator=(const TypedPV&) = delete;
+
+    PV* get_pv() {return pv;};
+    chtype get_read_type() {return readType;};
+    unsigned long get_element_count() {return elementCount;};
+
+    TypeValue read();
+    std::vector<TypeValue> read_array();
+    void write(const TypeValue& m_value);
+    void write_array(const std::vector<TypeValue>& m_values);
+
+    //Monitor with the value already converted; callbacks run on CA threads
+    void add_monitor(typedCallback m_callback, void* m_usr);
+    void remove_monitors();
+};
+} // namespace epics
+#endif
@@ -0,0 +1,139 @@
+#ifndef CAARCHIVE_H
+#define CAARCHIVE_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+
+namespace epics {
+
+struct ringRecord;
+
+/*
+Columnar archive of scalar PV history.
+
+Samples are grouped per PV into blocks of up to block_size samples. Each block stores
+its timestamps and its values as two separate bit-packed columns:
+    timestamps  nanoseconds since the EPICS epoch, first raw, then delta-of-delta coded
+    values      doubles, first raw, then XOR coded against the previous value (Gorilla)
+
+File layout:
+    archiveFileHeader, then pv_count names of name_size bytes
+    a sequence of blocks and index segments, each starting with its own magic
+    archiveFooter (only present after a clean close)
+An index segment lists the blocks written since the previous segment and points back
+to it; the footer points to the last segment. A file without a footer (writer crashed)
+is recovered by scanning the blocks forward from the header.
+*/
+struct archiveFileHeader {
+    char magic[8];              //"EPARCH01"
+    uint32_t version;
+    uint32_t pv_count;
+    uint32_t name_size;
+    uint32_t block_size;
+};
+
+struct archiveBlockHeader {
+    uint32_t magic;             //archiveBlockMagic
+    uint32_t pv_index;
+    uint32_t count;
+    uint32_t timestamp_bytes;
+    uint32_t value_bytes;
+    uint32_t reserved;
+    int64_t first_timestamp;
+    int64_t last_timestamp;
+};
+
+struct archiveIndexEntry {
+    uint32_t pv_index;
+    uint32_t count;
+    int64_t first_timestamp;
+    int64_t last_timestamp;
+    uint64_t offset;            //File offset of the archiveBlockHeader
+};
+
+struct archiveIndexHeader {
+    uint32_t magic;             //archiveIndexMagic
+    uint32_t count;
+    uint64_t previous;          //Offset of the previous index segment, 0 if none
+};
+
+struct archiveFooter {
+    uint64_t last_index;
+    char magic[8];              //"EPAREND1"
+};
+
+struct archiveSample {
+    int64_t timestamp;          //Nanoseconds since the EPICS epoch (1990-01-01)
+    double value;
+};
+
+/*
+Appends samples to an archive file. Encoding happens in memory per PV; a block is
+written once it holds block_size samples. Not thread safe: feed it from one thread,
+for example by draining a caRingReader.
+*/
+class caArchiveWriter {
+    private:
+    struct encoder;
+
+    std::FILE* file = nullptr;
+    std::string path;
+    uint32_t blockSize;
+    uint32_t indexInterval;
+    uint64_t lastIndex = 0;
+    uint64_t bytesWritten = 0;
+    uint64_t samplesWritten = 0;
+    std::vector<encoder*> encoders;
+    std::vector<archiveIndexEntry> pendingIndex;
+
+    void _write(const void* data, std::size_t bytes);
+    void _write_block(uint32_t pv_index);
+    void _write_index();
+
+    public:
+    static const uint32_t name_size = 128;
+
+    caArchiveWriter(std::string m_path, std::vector<std::string> m_pvNames,
+                    uint32_t m_blockSize = 1024, uint32_t m_indexInterval = 64);
+    ~caArchiveWriter();
+
+    void append(uint32_t pv_index, int64_t timestamp, double value);
+    //Append a numeric ring record; returns false for records that cannot be archived
+    bool append(const ringRecord& record);
+
+    //Write partially filled blocks, the last index segment and the footer
+    void close();
+
+    uint64_t get_bytes_written() {return bytesWritten;};
+    uint64_t get_samples_written() {return samplesWritten;};
+};
+
+class caArchiveReader {
+    private:
+    std::FILE* file = nullptr;
+    std::vector<std::string> pvNames;
+    std::vector<archiveIndexEntry> blocks;
+    bool complete = false;
+
+    void _load_index(uint64_t last_index);
+    void _scan_blocks(uint64_t offset);
+
+    public:
+    caArchiveReader(std::string m_path);
+    ~caArchiveReader();
+
+    std::vector<std::string> get_pv_names() {return pvNames;};
+    std::vector<archiveIndexEntry> get_blocks() {return blocks;};
+    //False when the file had no footer and the index was rebuilt by scanning
+    bool is_complete() {return complete;};
+
+    //Samples of one PV with begin <= timestamp <= end, in write order
+    std::vector<archiveSample> read(uint32_t pv_index, int64_t begin = INT64_MIN, int64_t end = INT64_MAX);
+
+    static std::vector<archiveSample> decode_block(const archiveBlockHeader& header, const uint8_t* columns);
+};
+} // namespace epics
+#endif
@@ -0,0 +1,135 @@
+#ifndef CACHANNELTABLE_H
+#define CACHANNELTABLE_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <unordered_map>
+#include <functional>
+#include <cstddef>
+#include <cstdint>
+
+#include <cadef.h>
+#include <db_access.h>
+
+#include "caTransport.h"
+
+namespace epics {
+
+//Told when the shared channel connects or disconnects; usr is the user's own pointer
+typedef void channelStateFunc(void* usr, bool m_connected);
+
+struct channelUser {
+    channelStateFunc* on_state;
+    void* usr;
+};
+
+struct sharedChannel;
+
+typedef std::vector<std::pair<caEventCallBackFunc*, void*>> subscriberList;
+
+//One CA subscription fanned out to every local subscriber with the same type, count and mask
+struct sharedSubscription : std::enable_shared_from_this<sharedSubscription> {
+    sharedChannel* owner;
+    chtype type;
+    unsigned long count;
+    long mask;
+    evid monitor = nullptr;
+    std::mutex mutex;
+    std::condition_variable released;   //Notified when a delivery ends
+    //Replaced, never changed in place, so events are delivered from a snapshot without the lock
+    std::shared_ptr<const subscriberList> subscribers;
+    bool delivered = false;             //CA has sent the first value
+    //Deliveries running, by the parity of the epoch they started in. Removing a subscriber
+    //waits out the other parity, starts a new epoch and waits out the old one, so no
+    //delivery that started before the removal is left.
+    uint64_t epoch = 0;
+    unsigned active[2] = {0, 0};
+    bool retiring = false;              //A removal is waiting; the next one queues behind it
+};
+
+//A channel and everyone using it. puser of the chid points here.
+struct sharedChannel {
+    std::string name;
+    struct ca_client_context* context = nullptr;    //CA context the chid belongs to
+    chid channel = nullptr;
+    std::mutex mutex;
+    std::atomic<bool> connected{false};
+    std::vector<channelUser> users;
+    std::vector<std::shared_ptr<sharedSubscription>> subscriptions;
+    //Objects a pending CA callback of this channel may still use, freed after the channel
+    //is cleared since that cancels the callback
+    std::vector<std::shared_ptr<void>> leftovers;
+};
+
+struct channelTableStats {
+    std::size_t channels = 0;       //CA channels open
+    std::size_t users = 0;          //PVs holding them
+    std::size_t subscriptions = 0;  //CA subscriptions open
+    std::size_t subscribers = 0;    //Local monitors fed by them
+};
+
+/*
+Process-wide table of CA channels keyed by CA context and full PV name. PVs with the same
+name whose proxies use the same context share one chid: the first acquire creates the
+channel, the last release clears it. Proxies created on different threads have their own
+CA contexts and so their own channels, since a chid is only waited for by ca_pend_io of
+its own context and goes away with it. The context is the caller's current one, so
+threads working for a proxy must attach its context first. Monitors with the same type, count and mask share one CA subscription whose
+events are fanned out locally, so duplicate monitors add no network traffic. Events are
+passed on in place from a snapshot of the subscribers, with no lock held, so callbacks may
+add or remove monitors, their own included. Removing a subscriber waits for an event still
+being delivered to it on another thread. A subscriber that joins after the first event is
+sent the current value by a one-shot get, as CA does for a new subscription; CA answers
+in order on the circuit, so the value cannot overtake a newer event.
+*/
+class caChannelTable {
+    private:
+    struct channelKey {
+        struct ca_client_context* context;
+        std::string name;
+        bool operator==(const channelKey& m_other) const {return context == m_other.context && name == m_other.name;};
+    };
+    struct channelKeyHash {
+        std::size_t operator()(const channelKey& m_key) const {
+            return std::hash<std::string>()(m_key.name) ^ std::hash<void*>()(m_key.context);
+        }
+    };
+
+    std::mutex mutex;
+    std::unordered_map<channelKey, sharedChannel*, channelKeyHash> channels;
+
+    static void connection_callback(struct connection_handler_args args);
+    static void event_callback(struct event_handler_args args);
+    static void join_callback(struct event_handler_args args);
+    static void _deliver(sharedSubscription* m_subscription, struct event_handler_args args, caEventCallBackFunc* m_only);
+
+    public:
+    static caChannelTable& instance();
+
+    //Reference the channel for m_name in the current CA context, creating it (at
+    //m_priority) if nobody there holds it yet.
+    //Throws when CA refuses to create the channel.
+    sharedChannel* acquire(std::string m_name, unsigned m_priority, channelUser m_user);
+    void release(sharedChannel* m_channel, void* m_usr);
+
+    //Keep m_object until the last release of m_channel has cleared it, for a user that goes
+    //away while a callback it issued is still outstanding
+    void keep_until_cleared(sharedChannel* m_channel, std::shared_ptr<void> m_object);
+
+    //Subscribe m_callback with m_usr, sharing an existing subscription when one matches.
+    //Throws when CA refuses a new subscription.
+    sharedSubscription* subscribe(sharedChannel* m_channel, chtype m_type, unsigned long m_count, long m_mask,
+                                  caEventCallBackFunc* m_callback, void* m_usr);
+    void unsubscribe(sharedSubscription* m_subscription, void* m_usr);
+
+    //The usr pointer of the channel's first user, e.g. for attributing CA exceptions
+    static void* first_user(chid m_channel);
+
+    channelTableStats stats();
+};
+} // namespace epics
+#endif
@@ -0,0 +1,72 @@
+#ifndef CACHUNKEDARRAY_H
+#define CACHUNKEDARRAY_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+#include <cadef.h>
+#include <db_access.h>
+
+#include "caTransport.h"
+#include "caChannelTable.h"
+#include "caStats.h"
+
+namespace epics {
+
+struct chunkConfig {
+    std::size_t chunk_bytes = 0;    //Bytes per piece; 0 uses EPICS_CA_MAX_ARRAY_BYTES (16384 if unset)
+    unsigned in_flight = 4;         //Pieces requested before waiting for their replies
+    std::string offset_pv;          //Writes: full name of the record taking a piece's first element
+    std::string data_pv;            //Writes: full name of the record taking a piece's elements
+};
+
+/*
+Transfers arrays larger than one CA message in bounded pieces. Reads go through array
+filter channels ("wf.[first:last]", EPICS 3.15 and later), one per piece, that are
+created on the first large read and kept. Up to in_flight pieces are requested at once
+and each is written by CA straight to its place in the destination, so nothing is
+assembled through an intermediate buffer. Puts through a filter channel write the whole
+field, so writes need an offset record and a data record on the IOC that store a piece
+at an offset of the waveform. Each piece is sent as an offset put followed by a data put;
+CA keeps the order of requests on a circuit, so several pieces can be in flight.
+*/
+class caChunkedArray {
+    private:
+    std::string pvName;
+    unsigned priority;
+    chunkConfig config;
+    caCounters* stats = nullptr;
+    //Filter channels of the current layout: one per piece of pieceElements elements
+    std::vector<sharedChannel*> pieces;
+    unsigned long pieceElements = 0;
+    unsigned long totalElements = 0;
+    sharedChannel* offsetChannel = nullptr;
+    sharedChannel* dataChannel = nullptr;
+
+    static void piece_state(void* usr, bool m_connected);
+    void _release();
+    void _wait_connected(std::vector<sharedChannel*> m_channels, std::string m_message);
+    void _pend_io(std::string m_message);
+    void _layout(unsigned long m_pieceElements, unsigned long m_totalElements);
+
+    public:
+    caChunkedArray(std::string m_pvName, unsigned m_priority, chunkConfig m_config, caCounters* m_stats = nullptr);
+    ~caChunkedArray();
+    caChunkedArray(const caChunkedArray&) = delete;
+    caChunkedArray& operator=(const caChunkedArray&) = delete;
+
+    chunkConfig get_config() {return config;};
+    //Elements of m_type in one piece
+    unsigned long piece_elements(chtype m_type);
+    //True when m_count elements of m_type do not fit in one piece
+    bool needs_pieces(chtype m_type, unsigned long m_count);
+    bool can_write() {return !config.offset_pv.empty() && !config.data_pv.empty();};
+
+    //Read m_count elements of plain DBR type m_type into m_dest
+    void read(chtype m_type, unsigned long m_count, void* m_dest);
+    //Write m_count elements of plain DBR type m_type from m_src through the offset and data records
+    void write(chtype m_type, unsigned long m_count, const void* m_src);
+};
+} // namespace epics
+#endif
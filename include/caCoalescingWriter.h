@@ -0,0 +1,76 @@
+#ifndef CACOALESCINGWRITER_H
+#define CACOALESCINGWRITER_H
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+
+#include <cadef.h>
+#include <db_access.h>
+
+#include "caTransport.h"
+#include "caWriteBuffer.h"
+#include "caLatency.h"
+#include "caStats.h"
+
+namespace epics {
+
+struct coalescingCounters {
+    unsigned long sent = 0;         //Puts issued to the IOC
+    unsigned long dropped = 0;      //Values replaced by a newer one before they were sent
+    unsigned long in_flight = 0;    //Puts issued but not yet completed (0 or 1)
+    unsigned long failed = 0;       //Completions reporting a CA error
+};
+
+/*
+Per-channel writer that keeps at most one put outstanding. Puts are issued with
+ca_array_put_callback; while one is in flight, a new value is parked in a single
+pending slot and any value already parked there is dropped. The completion callback
+sends the pending value, so a slow IOC only ever sees the latest setpoint. A value
+that cannot be sent, or whose put was lost to a disconnect, stays pending until the
+owner calls resend() on reconnect.
+*/
+class caCoalescingWriter {
+    private:
+    std::mutex mutex;
+    std::condition_variable idle;   //Notified when the put in flight completes
+    chid channel;
+    std::string pvName;
+    caWriteBuffer* writeBuffer = nullptr;
+    caLatencyStats* latency = nullptr;
+    caCounters* stats = nullptr;
+    uint64_t sentAt = 0;
+    bool inFlight = false;
+    bool hasPending = false;
+    bool orphaned = false;          //Owner gone; kept by the channel table until the channel is cleared
+    chtype pendingType = DBR_DOUBLE;
+    unsigned long pendingCount = 0;
+    std::vector<char> pending;
+    coalescingCounters counters;
+
+    static void put_callback(struct event_handler_args args);
+    void _send(bool from_callback);
+
+    public:
+    caCoalescingWriter(chid m_channel, std::string m_pvName, caLatencyStats* m_latency = nullptr, caCounters* m_stats = nullptr);
+
+    void set_write_buffer(caWriteBuffer* m_writeBuffer);
+
+    //Queue a value of count elements of the given DBR type. Never blocks on the IOC.
+    void write(chtype type, unsigned long count, const void* value);
+
+    //Send the pending value, if any, when nothing is in flight; for reconnects
+    void resend();
+
+    coalescingCounters get_counters();
+
+    //Free a writer once its put in flight has completed, waiting up to m_timeout seconds.
+    //Returns false for a put still outstanding after that: the writer is then cut off from
+    //its owner's statistics but not freed, since its callback may yet come. Clearing the
+    //channel cancels that callback, so the caller hands the writer to
+    //caChannelTable::keep_until_cleared.
+    static bool retire(caCoalescingWriter* m_writer, double m_timeout);
+};
+} // namespace epics
+#endif
@@ -0,0 +1,62 @@
+#ifndef CACONVERT_H
+#define CACONVERT_H
+
+#include <cstddef>
+
+#include <cadef.h>
+#include <db_access.h>
+
+namespace epics {
+
+enum simdLevel {
+    SIMD_SCALAR,
+    SIMD_AVX2,
+    SIMD_AVX512
+};
+
+//Statistics of one array, from a single pass of caConvert::reduce
+struct arrayStats {
+    unsigned long count = 0;
+    double min = 0.0;
+    double max = 0.0;
+    double sum = 0.0;
+    double weighted = 0.0;          //Sum of index * value
+
+    double mean() const {return count != 0 ? sum / count : 0.0;};
+    //Value-weighted mean index, e.g. the centre of a beam profile; 0 when the sum is 0
+    double centroid() const {return sum != 0.0 ? weighted / sum : 0.0;};
+};
+
+/*
+Conversion of CA array buffers to double, optionally scaled as scale * value + offset
+(e.g. an EGU conversion), written straight into the destination. Kernels for AVX-512
+and AVX2 are chosen at runtime from what the CPU supports, with a scalar loop on other
+CPUs and compilers. Unscaled conversions are exact at every level. Scaled ones may
+differ in the last bit between levels where the compiler fuses the multiply and add.
+*/
+class caConvert {
+    public:
+    //Best level this CPU supports
+    static simdLevel detected();
+    //Level in use; set_level is clamped to detected() and is meant for benchmarks
+    static simdLevel get_level();
+    static void set_level(simdLevel m_level);
+    static const char* level_name(simdLevel m_level);
+
+    static void to_double(const dbr_double_t* m_src, double* m_dst, std::size_t m_count, double m_scale = 1.0, double m_offset = 0.0);
+    static void to_double(const dbr_float_t* m_src, double* m_dst, std::size_t m_count, double m_scale = 1.0, double m_offset = 0.0);
+    static void to_double(const dbr_long_t* m_src, double* m_dst, std::size_t m_count, double m_scale = 1.0, double m_offset = 0.0);
+    static void to_double(const dbr_short_t* m_src, double* m_dst, std::size_t m_count, double m_scale = 1.0, double m_offset = 0.0);
+    static void to_double(const dbr_enum_t* m_src, double* m_dst, std::size_t m_count, double m_scale = 1.0, double m_offset = 0.0);
+    static void to_double(const dbr_char_t* m_src, double* m_dst, std::size_t m_count, double m_scale = 1.0, double m_offset = 0.0);
+
+    //Values of DBR type m_type (not DBR_STRING), throws for other types
+    static void to_double(const void* m_src, chtype m_type, double* m_dst, std::size_t m_count, double m_scale = 1.0, double m_offset = 0.0);
+
+    //Min, max, sum and index-weighted sum of m_count values of DBR type m_type in one pass,
+    //with the same kernels. Sums are added in a different order at each level, so they may
+    //differ in the last bits; min and max of arrays holding NaN are unspecified.
+    static arrayStats reduce(const void* m_src, chtype m_type, std::size_t m_count);
+};
+} // namespace epics
+#endif
@@ -0,0 +1,151 @@
+#ifndef CAIMAGE_H
+#define CAIMAGE_H
+
+#include <string>
+#include <array>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+
+#include <cadef.h>
+#include <db_access.h>
+
+#include "PV.h"
+#include "caTripleBuffer.h"
+
+namespace epics {
+
+//areaDetector NDDataType_t, as served by DataType_RBV
+enum ndDataType {
+    ND_INT8,
+    ND_UINT8,
+    ND_INT16,
+    ND_UINT16,
+    ND_INT32,
+    ND_UINT32,
+    ND_INT64,
+    ND_UINT64,
+    ND_FLOAT32,
+    ND_FLOAT64
+};
+
+/*
+Read-only view of an image with up to three dimensions, like std::mdspan with a
+layout where dimension 0 varies fastest (areaDetector order: x, then y, then color or
+frame). It does not own the elements.
+*/
+template<typename T>
+class imageView {
+    private:
+    const T* values = nullptr;
+    std::array<std::size_t, 3> extents = {0, 1, 1};
+    std::size_t dimensions = 0;
+
+    public:
+    imageView(const T* m_values, std::array<std::size_t, 3> m_extents, std::size_t m_rank) {
+        values = m_values;
+        extents = m_extents;
+        dimensions = m_rank;
+    }
+
+    std::size_t rank() const {return dimensions;};
+    std::size_t extent(std::size_t m_dim) const {return extents[m_dim];};
+    std::size_t size() const {return extents[0] * extents[1] * extents[2];};
+    const T* data_handle() const {return values;};
+
+    const T& operator()(std::size_t m_x) const {return values[m_x];};
+    const T& operator()(std::size_t m_x, std::size_t m_y) const {return values[m_y * extents[0] + m_x];};
+    const T& operator()(std::size_t m_x, std::size_t m_y, std::size_t m_z) const {
+        return values[(m_z * extents[1] + m_y) * extents[0] + m_x];
+    }
+};
+
+//One image: the newest ArrayData frame and the shape known when it was taken
+struct imageFrame {
+    const arrayFrame* frame = nullptr;
+    std::array<std::size_t, 3> dims = {0, 1, 1};
+    std::size_t ndims = 0;
+    ndDataType dataType = ND_UINT8;
+
+    //False when the shape PVs have not caught up with the frame size yet
+    bool consistent() const {return frame != nullptr && dims[0] * dims[1] * dims[2] == frame->count;};
+
+    //View over the frame in place. T must have the size and kind (integer or floating
+    //point) of the elements on the wire, so an unsigned view of signed data is allowed.
+    template<typename T>
+    imageView<T> view() const {
+        if (frame == nullptr || frame->sequence == 0) {
+            throw std::runtime_error("No image received yet");
+        }
+        bool floating = frame->type == DBR_FLOAT || frame->type == DBR_DOUBLE;
+        if (sizeof(T) != dbr_value_size[frame->type] || std::is_floating_point_v<T> != floating) {
+            throw std::runtime_error("Image elements of CA type " + std::to_string(frame->type)
+                                     + " cannot be viewed as a " + std::to_string(sizeof(T)) + " byte type");
+        }
+        if (dims[0] * dims[1] * dims[2] > frame->count) {
+            throw std::runtime_error("Image shape exceeds the " + std::to_string(frame->count) + " elements received");
+        }
+        return imageView<T>(frame->values<T>(), dims, ndims);
+    }
+};
+
+/*
+An areaDetector NDStdArrays plugin: the ArrayData waveform, monitored through a triple
+buffer, plus NDimensions_RBV, ArraySize0/1/2_RBV and DataType_RBV, which are monitored
+and cached so a frame costs no extra reads. latest() hands out the newest frame with its
+shape, and views read the frame in place. The shape PVs update independently of the
+data, so a frame taken right after a size change can carry the old shape;
+imageFrame::consistent() detects this. The image does not own its PVs and must be
+destroyed before the proxy that does; destroying it removes the monitors of ArrayData.
+Frames are for one reader thread.
+*/
+class caImage {
+    public:
+    enum shapeField {NDIMENSIONS, SIZE0, SIZE1, SIZE2, DATATYPE, SHAPE_FIELDS};
+    static constexpr std::array<const char*, SHAPE_FIELDS + 1> fieldNames = {
+        "NDimensions_RBV", "ArraySize0_RBV", "ArraySize1_RBV", "ArraySize2_RBV", "DataType_RBV", "ArrayData"};
+
+    private:
+    struct shapeHook {
+        std::atomic<long> value{0};
+        std::atomic<bool> received{false};
+        PV* pv = nullptr;
+        sharedSubscription* subscription = nullptr;
+    };
+
+    //Held by pointer so subscriptions keep their address when the image is moved
+    struct imageState {
+        PV* arrayData = nullptr;
+        caTripleBuffer* frames = nullptr;
+        std::array<shapeHook, SHAPE_FIELDS> shape;
+    };
+
+    std::string pluginName;
+    std::unique_ptr<imageState> state;
+
+    static void shape_callback(struct event_handler_args args);
+
+    public:
+    //m_pvs in the order of fieldNames
+    caImage(std::string m_pluginName, std::array<PV*, SHAPE_FIELDS + 1> m_pvs);
+    ~caImage();
+    caImage(caImage&&) = default;
+    caImage& operator=(caImage&&) = delete;
+
+    std::string get_name() {return pluginName;};
+    PV* get_array_pv() {return state->arrayData;};
+    caTripleBuffer* get_frames() {return state->frames;};
+
+    //Cached shape
+    std::size_t get_ndims();
+    std::array<std::size_t, 3> get_dims();
+    ndDataType get_data_type();
+
+    //Newest frame with the cached shape; frame->sequence is 0 before the first image
+    imageFrame latest();
+};
+} // namespace epics
+#endif
@@ -0,0 +1,102 @@
+#ifndef CALATENCY_H
+#define CALATENCY_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace epics {
+
+//Operations timed per PV
+enum latencyOp {
+    LATENCY_GET,                //get request to reply, including ca_pend_io
+    LATENCY_PUT,                //put request until it returns (queue time in buffered mode)
+    LATENCY_PUT_CALLBACK,       //put with callback until the IOC reports completion
+    LATENCY_CONNECT,            //channel creation until first connection
+    LATENCY_MONITOR_INTERVAL,   //time between consecutive events of one monitor
+    LATENCY_OP_COUNT
+};
+
+struct latencySnapshot {
+    uint64_t count = 0;
+    uint64_t min_ns = 0;
+    uint64_t max_ns = 0;
+    double mean_ns = 0.0;
+    uint64_t p50_ns = 0;
+    uint64_t p90_ns = 0;
+    uint64_t p99_ns = 0;
+    uint64_t p999_ns = 0;
+    std::vector<std::pair<uint64_t, uint64_t>> buckets;     //Non-empty buckets as (upper bound ns, count)
+};
+
+/*
+Log-linear (HDR style) histogram of nanosecond durations: 8 linear sub-buckets per
+power of two, so any recorded value is within 12.5% of its bucket bound, covering
+1 ns to about 36 minutes in 312 buckets. Recording is a handful of relaxed atomic
+operations and never locks.
+*/
+class latencyHistogram {
+    public:
+    static const int subBucketBits = 3;
+    static const int subBuckets = 1 << subBucketBits;
+    static const int maxShift = 38;
+    static const int bucketCount = (maxShift + 1) * subBuckets;
+
+    private:
+    std::atomic<uint32_t> buckets[bucketCount] = {};
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> sum{0};
+    std::atomic<uint64_t> min{UINT64_MAX};
+    std::atomic<uint64_t> max{0};
+
+    public:
+    static int bucket_index(uint64_t ns);
+    static uint64_t bucket_upper(int index);
+
+    void record(uint64_t ns);
+    latencySnapshot snapshot();
+};
+
+/*
+The histograms of one PV, one per latencyOp, allocated on first use so PVs that are
+never touched stay small. Building with -DEPICS_PROXY_NO_LATENCY compiles every
+timing call down to nothing.
+*/
+class caLatencyStats {
+    private:
+    std::atomic<latencyHistogram*> histograms[LATENCY_OP_COUNT] = {};
+
+    public:
+    caLatencyStats() {};
+    ~caLatencyStats();
+    caLatencyStats(const caLatencyStats&) = delete;
+    caLatencyStats& operator=(const caLatencyStats&) = delete;
+
+    //Timestamp for a later record() call; 0 when latency tracking is compiled out
+    static uint64_t now() {
+#ifndef EPICS_PROXY_NO_LATENCY
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+#else
+        return 0;
+#endif
+    }
+
+    void record(latencyOp op, uint64_t start) {
+#ifndef EPICS_PROXY_NO_LATENCY
+        record_duration(op, now() - start);
+#else
+        (void)op;
+        (void)start;
+#endif
+    }
+
+    void record_duration(latencyOp op, uint64_t ns);
+    latencySnapshot snapshot(latencyOp op);
+};
+
+const char* latency_op_name(latencyOp op);
+} // namespace epics
+#endif
@@ -0,0 +1,47 @@
+#ifndef CAMANIFEST_H
+#define CAMANIFEST_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstddef>
+
+#include <cadef.h>
+#include <db_access.h>
+
+namespace epics {
+
+struct manifestEntry {
+    std::string_view name;      //Points into the manifest's name table
+    chtype type = TYPENOTCONN;  //Expected native type, TYPENOTCONN when not checked
+    unsigned priority = 20;     //CA priority, 0 (default) to 99 (CA_PRIORITY_MAX)
+};
+
+/*
+A PV manifest: one PV per line as "name [type] [priority]". type is one of double,
+float, enum, short, char, string or long (or "-" to skip the check); priority defaults
+to 20. Blank lines and text after '#' are ignored. The file is read in one go and
+names are interned: each distinct name is stored once in the manifest's text and
+entries refer to it, so a repeated name is dropped and counted as a duplicate.
+*/
+class caManifest {
+    private:
+    std::string text;
+    std::vector<manifestEntry> entries;
+    std::size_t duplicates = 0;
+
+    void _parse(std::string m_path);
+
+    public:
+    caManifest(std::string m_path);
+    caManifest(const caManifest&) = delete;
+    caManifest& operator=(const caManifest&) = delete;
+
+    const std::vector<manifestEntry>& get_entries() {return entries;};
+    std::size_t get_duplicates() {return duplicates;};
+
+    //DBR type of a manifest type name, throws for unknown names
+    static chtype type_from_name(std::string_view m_name);
+};
+} // namespace epics
+#endif
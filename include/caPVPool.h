@@ -0,0 +1,34 @@
+#ifndef CAPVPOOL_H
+#define CAPVPOOL_H
+
+#include <string>
+#include <cstddef>
+
+#include "PV.h"
+
+namespace epics {
+
+/*
+Fixed-capacity slab of PV objects. Bulk loads construct their PVs here instead of with
+one new each, so tens of thousands of PVs take a single allocation and sit next to
+each other in memory. PVs are destroyed with the pool, in reverse order of creation.
+*/
+class caPVPool {
+    private:
+    PV* slots = nullptr;
+    std::size_t capacity = 0;
+    std::size_t size = 0;
+
+    public:
+    caPVPool(std::size_t m_capacity);
+    ~caPVPool();
+    caPVPool(const caPVPool&) = delete;
+    caPVPool& operator=(const caPVPool&) = delete;
+
+    //Construct a PV in the next free slot, throws when the pool is full
+    PV* create(std::string m_deviceName, std::string m_fieldName, unsigned m_priority, bool m_lazy = false);
+    bool owns(const PV* m_pv) {return m_pv >= slots && m_pv < slots + size;};
+    std::size_t get_size() {return size;};
+};
+} // namespace epics
+#endif
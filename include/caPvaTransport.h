@@ -0,0 +1,113 @@
+#ifndef CAPVATRANSPORT_H
+#define CAPVATRANSPORT_H
+
+//Built only when the EPICS 7 pvAccess libraries are available (make PVA=1)
+#ifdef EPICS_PROXY_WITH_PVA
+
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+
+#include <pva/client.h>
+#include <pv/pvData.h>
+
+#include "caTransport.h"
+
+namespace epics {
+
+struct pvaConfig {
+    std::string provider = "pva";       //pvAccess client provider name
+    std::string monitor_options = "";   //pvRequest record options for monitors, e.g. "record[queueSize=4]"
+};
+
+/*
+Transport that talks pvAccess (EPICS 7) instead of Channel Access, behind the same
+CA-shaped interface, so EpicsProxy and PV work unchanged. Arrays are not limited by
+EPICS_CA_MAX_ARRAY_BYTES. Every operation sends a pvRequest selecting only the fields
+it needs: field(value) for plain DBR types and field(value,timeStamp,alarm) for DBR_TIME
+types, so monitor updates carry just the changed value and metadata.
+
+The native type of a channel is learned with one get after each connect, and the
+connection handler runs once it is known, so field_type and element_count behave as
+in CA. Integer and float scalars and arrays, strings and NTEnum values are mapped to
+the closest DBR type; 64-bit integers map to DBR_DOUBLE as in the CA gateway.
+Callbacks run on pvAccess worker threads, like CA with preemptive callbacks.
+*/
+class caPvaTransport : public caTransport {
+    private:
+    struct pvaChannel;
+    struct pvaOperation;
+    struct pvaSubscription;
+
+    pvaConfig config;
+    std::mutex mutex;
+    std::condition_variable done;
+    pvac::ClientProvider provider;
+    int contexts = 0;
+    uint64_t nextId = 1;
+
+    std::map<uint64_t, std::unique_ptr<pvaChannel>> channels;
+    std::map<uint64_t, std::unique_ptr<pvaOperation>> operations;
+    std::map<uint64_t, std::unique_ptr<pvaSubscription>> subscriptions;
+    unsigned long outstanding = 0;      //Gets and puts that pend_io waits for
+    bool pendingFailure = false;
+
+    caExceptionHandler* exceptionHandler = nullptr;
+    void* exceptionUsr = nullptr;
+
+    pvaChannel* _channel(chid channel);
+    void _finished(pvaOperation* operation, bool blocking, bool failed);
+    void _reap();
+    void _cancel(std::vector<pvaOperation*> m_operations);
+    int _start_get(chtype type, unsigned long count, chid channel, void* value,
+                   caEventCallBackFunc* callback, void* usr);
+    int _start_put(chtype type, unsigned long count, chid channel, const void* value,
+                   caEventCallBackFunc* callback, void* usr);
+
+    public:
+    static std::string request_for(chtype type);
+    static chtype native_type(const ::epics::pvData::PVStructure& root, unsigned long* count);
+    static int encode(const ::epics::pvData::PVStructure& root, chtype type, unsigned long count, void* value);
+
+    caPvaTransport(pvaConfig m_config = pvaConfig());
+    ~caPvaTransport();
+
+    int context_create(enum ca_preemptive_callback_select select) override;
+    void context_destroy() override;
+    struct ca_client_context* current_context() override;
+    int attach_context(struct ca_client_context* context) override;
+    void detach_context() override;
+
+    int create_channel(const char* name, caCh* conn_callback, void* puser, unsigned priority, chid* channel) override;
+    int clear_channel(chid channel) override;
+
+    int array_get(chtype type, unsigned long count, chid channel, void* value) override;
+    int array_get_callback(chtype type, unsigned long count, chid channel,
+                           caEventCallBackFunc* callback, void* usr) override;
+    int array_put(chtype type, unsigned long count, chid channel, const void* value) override;
+    int array_put_callback(chtype type, unsigned long count, chid channel, const void* value,
+                           caEventCallBackFunc* callback, void* usr) override;
+
+    int create_subscription(chtype type, unsigned long count, chid channel, long mask,
+                            caEventCallBackFunc* callback, void* usr, evid* monitor) override;
+    int clear_subscription(evid monitor) override;
+
+    int pend_io(double timeout) override;
+    int pend_event(double timeout) override;
+    int flush_io() override;
+    int add_exception_event(caExceptionHandler* handler, void* usr) override;
+
+    chtype field_type(chid channel) override;
+    unsigned long element_count(chid channel) override;
+    enum channel_state state(chid channel) override;
+    const char* name(chid channel) override;
+    void* puser(chid channel) override;
+};
+} // namespace epics
+#endif // EPICS_PROXY_WITH_PVA
+#endif
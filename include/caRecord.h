@@ -0,0 +1,138 @@
+#ifndef CARECORD_H
+#define CARECORD_H
+
+#include <string>
+#include <array>
+#include <cstddef>
+#include <algorithm>
+#include <type_traits>
+
+#include <cadef.h>
+#include <db_access.h>
+
+#include "PV.h"
+
+namespace epics {
+
+//A field name usable as a template argument, e.g. recordField<".RBV", double>
+template<std::size_t N>
+struct recordFieldName {
+    char value[N];
+    constexpr recordFieldName(const char (&m_name)[N]) {std::copy_n(m_name, N, value);}
+};
+
+//One field of a record type: its name suffix and the C++ type of its native DBR type
+template<recordFieldName Name, typename TypeValue>
+struct recordField {
+    typedef TypeValue type;
+    static constexpr const char* name = Name.value;
+};
+
+//The fields of a record type, in the order their PVs are created
+template<typename... Fields>
+struct recordFields {
+    static constexpr std::size_t size = sizeof...(Fields);
+    static constexpr std::array<const char*, size> names = {Fields::name...};
+
+    //Position of Field in the list, or size when it is not a member
+    template<typename Field>
+    static constexpr std::size_t index() {
+        constexpr bool matches[] = {std::is_same_v<Field, Fields>...};
+        for (std::size_t i = 0; i < size; i++) {
+            if (matches[i]) {
+                return i;
+            }
+        }
+        return size;
+    }
+};
+
+//Motor record (motorRecord from the EPICS motor module)
+struct Motor {
+    typedef recordField<".VAL", double> VAL;     //Setpoint
+    typedef recordField<".RBV", double> RBV;     //Readback
+    typedef recordField<".MSTA", double> MSTA;   //Status bits, served as DBR_DOUBLE
+    typedef recordField<".DMOV", short> DMOV;    //Done moving
+    typedef recordField<".STOP", short> STOP;
+    typedef recordFields<VAL, RBV, MSTA, DMOV, STOP> fields;
+};
+
+//Analog input record
+struct AnalogIn {
+    typedef recordField<".VAL", double> VAL;
+    typedef recordField<".EGU", std::string> EGU;
+    typedef recordField<".SEVR", short> SEVR;
+    typedef recordFields<VAL, EGU, SEVR> fields;
+};
+
+//Analog output record
+struct AnalogOut {
+    typedef recordField<".VAL", double> VAL;
+    typedef recordField<".OVAL", double> OVAL;
+    typedef recordField<".EGU", std::string> EGU;
+    typedef recordField<".SEVR", short> SEVR;
+    typedef recordFields<VAL, OVAL, EGU, SEVR> fields;
+};
+
+/*
+The PVs of one record, created as a group by EpicsProxy::create_record. Fields are
+addressed by type, e.g. axis.get<Motor::RBV>(), which resolves to an array index at
+compile time: there is no name lookup, and naming a field the record type does not
+declare, or putting a value of the wrong type, fails to compile. Record types are
+plain structs like Motor, so new ones can be declared next to the code that uses them.
+*/
+template<typename Record>
+class caRecord {
+    public:
+    typedef typename Record::fields fields;
+
+    private:
+    std::string recordName;
+    std::array<PV*, fields::size> pvs;
+
+    template<typename Field>
+    static constexpr std::size_t _index() {
+        constexpr std::size_t index = fields::template index<Field>();
+        static_assert(index < fields::size, "Field is not declared by this record type");
+        return index;
+    }
+
+    public:
+    caRecord(std::string m_recordName, std::array<PV*, fields::size> m_pvs) {
+        recordName = m_recordName;
+        pvs = m_pvs;
+    }
+
+    std::string get_name() {return recordName;};
+
+    template<typename Field>
+    PV* pv() {return pvs[_index<Field>()];}
+
+    template<typename Field>
+    typename Field::type get() {
+        if constexpr (std::is_same_v<typename Field::type, std::string>) {
+            return pv<Field>()->read_string();
+        } else {
+            return pv<Field>()->template read<typename Field::type>();
+        }
+    }
+
+    template<typename Field>
+    void put(typename Field::type m_value) {
+        if constexpr (std::is_same_v<typename Field::type, std::string>) {
+            pv<Field>()->write_string(m_value);
+        } else {
+            pv<Field>()->template write<typename Field::type>(m_value);
+        }
+    }
+
+    template<typename Field>
+    void add_monitor(EpicsProxy* proxy, void (*callback)(struct event_handler_args args)) {
+        pv<Field>()->add_monitor(proxy, callback);
+    }
+
+    template<typename Field>
+    void remove_monitor() {pv<Field>()->remove_monitor();}
+};
+} // namespace epics
+#endif
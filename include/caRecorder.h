@@ -0,0 +1,118 @@
+#ifndef CARECORDER_H
+#define CARECORDER_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+#include <cadef.h>
+#include <db_access.h>
+
+#include "caChannelTable.h"
+
+namespace epics {
+
+class PV;
+
+/*
+Ring file layout (all integers little-endian, host order):
+    ringFileHeader                      at offset 0
+    pv_count names of name_size bytes   at offset sizeof(ringFileHeader), NUL padded
+    capacity ringRecords                at records_offset (page aligned)
+Record i of the stream lives in slot i % capacity. A record is complete when its
+seq equals i + 1; writers set seq to 0 before filling the slot.
+*/
+struct ringFileHeader {
+    char magic[8];              //"EPRING01"
+    uint32_t version;
+    uint32_t record_size;
+    uint64_t capacity;
+    uint32_t pv_count;
+    uint32_t name_size;
+    uint64_t records_offset;
+    alignas(64) uint64_t write_index;   //Next record number, claimed with an atomic fetch_add
+};
+
+struct ringRecord {
+    uint64_t seq;
+    uint32_t sec_past_epoch;    //EPICS time stamp of the event (seconds since 1990)
+    uint32_t nsec;
+    uint32_t pv_index;          //Index into the name table
+    int16_t dbr_type;           //Plain DBR_ value type (DBR_DOUBLE, DBR_LONG, ...)
+    int16_t severity;
+    uint32_t count;             //Element count of the event; value holds the leading bytes
+    int16_t status;
+    int16_t reserved;
+    uint8_t value[32];
+};
+
+/*
+Records monitor events for a set of PVs into a preallocated memory-mapped ring file.
+Each CA callback thread claims a record with a single atomic increment and writes it
+in place, so recording never locks or allocates. The file survives a crash of the
+process and can be read back with caRingReader.
+*/
+class caRecorder {
+    private:
+    struct subscription {
+        caRecorder* recorder;
+        uint32_t pv_index;
+        sharedSubscription* monitor;
+    };
+
+    std::string path;
+    int fd = -1;
+    void* mapping = nullptr;
+    std::size_t mappingSize = 0;
+    ringFileHeader* header = nullptr;
+    ringRecord* records = nullptr;
+    std::vector<subscription*> subscriptions;
+
+    static void event_callback(struct event_handler_args args);
+    void _append(uint32_t pv_index, const struct event_handler_args& args);
+
+    public:
+    static const uint32_t name_size = 128;
+
+    caRecorder(std::string m_path, std::vector<std::string> m_pvNames, std::size_t m_capacity);
+    ~caRecorder();
+
+    //Subscribe to a PV already listed in the name table at construction. The DBR_TIME_
+    //request is taken from the field type, so a PV that is not connected is not subscribed
+    //and false is returned; call add again once it connects.
+    bool add(PV* m_pv, uint32_t m_pvIndex);
+    void stop();
+
+    std::string get_path() {return path;};
+    uint64_t get_write_index();
+};
+
+/*
+Read-only view of a ring file written by caRecorder, for external tools and post-mortem
+analysis. Safe to use while the recorder is still writing; torn records are skipped.
+*/
+class caRingReader {
+    private:
+    int fd = -1;
+    void* mapping = nullptr;
+    std::size_t mappingSize = 0;
+    const ringFileHeader* header = nullptr;
+    const ringRecord* records = nullptr;
+    std::vector<std::string> pvNames;
+
+    public:
+    caRingReader(std::string m_path);
+    ~caRingReader();
+
+    std::vector<std::string> get_pv_names() {return pvNames;};
+    uint64_t get_capacity() {return header->capacity;};
+
+    //Complete records, oldest first. With last_seconds > 0 only records whose time stamp
+    //is within last_seconds of the newest record are returned.
+    std::vector<ringRecord> read(double last_seconds = 0.0);
+
+    static double value_as_double(const ringRecord& record);
+};
+} // namespace epics
+#endif
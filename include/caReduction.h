@@ -0,0 +1,41 @@
+#ifndef CAREDUCTION_H
+#define CAREDUCTION_H
+
+#include <mutex>
+#include <cstdint>
+
+#include <cadef.h>
+#include <db_access.h>
+
+#include "caConvert.h"
+
+namespace epics {
+
+//Told of each reduced event on the CA thread; must return quickly
+typedef void reductionCallback(const arrayStats& m_stats, void* usr);
+
+/*
+A reduction stage on an array monitor. Each event is reduced on the CA callback thread
+by the caConvert::reduce kernels, straight from the CA event buffer, and only the
+statistics are kept: a consumer polls latest() or is called back with them, and the
+array itself is never copied.
+*/
+class caReduction {
+    private:
+    std::mutex mutex;
+    arrayStats last;
+    uint64_t sequence = 0;
+    reductionCallback* callback = nullptr;
+    void* usr = nullptr;
+
+    public:
+    caReduction(reductionCallback* m_callback = nullptr, void* m_usr = nullptr);
+
+    //Reduce one event of m_count values of plain DBR type m_type
+    void process(const void* m_values, chtype m_type, unsigned long m_count);
+
+    //Statistics of the newest event; m_sequence gets its number (0 before the first event)
+    arrayStats latest(uint64_t* m_sequence = nullptr);
+};
+} // namespace epics
+#endif
@@ -0,0 +1,86 @@
+#ifndef CAREPLAY_H
+#define CAREPLAY_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <atomic>
+#include <cstdint>
+
+#include <cadef.h>
+#include <db_access.h>
+
+namespace epics {
+
+/*
+Replay event file format (plain text, one event per line):
+
+    # comment
+    <time> <pv name> <value> [<value> ...]
+
+<time> is in seconds (any epoch, fractional part allowed); only differences between
+events matter. Values are whitespace separated. An event whose values all parse as
+numbers is numeric, with one element per value. Anything else is a string event
+whose value is the remainder of the line. Archiver exports map onto this directly,
+for example with awk '{print $1, "sans:motor.RBV", $2}'. Events need not be sorted.
+*/
+
+struct replayStats {
+    uint64_t events = 0;            //Callbacks delivered
+    uint64_t skipped = 0;           //Events for PVs without a subscriber, and string events
+                                    //not delivered to a numeric subscriber (one per subscriber)
+    double seconds = 0.0;           //Wall clock time of the run
+    double events_per_second = 0.0;
+    double max_lag = 0.0;           //Worst lateness against the schedule, in seconds
+};
+
+/*
+Drives monitor callbacks from recorded data instead of a live IOC. Subscribers use the
+same callback signature and usr argument as PV::add_monitor, and receive an
+event_handler_args whose dbr holds the value converted to the requested DBR type.
+The chid in the arguments is null because no channel exists.
+*/
+class caReplay {
+    private:
+    struct subscriber {
+        std::string pvName;
+        chtype type;
+        void* usr;
+        void (*callback)(struct event_handler_args args);
+    };
+
+    struct replayEvent {
+        double time;
+        uint32_t name;                  //Index into names
+        std::vector<double> values;
+        std::string text;               //Set for string events
+    };
+
+    std::vector<std::string> names;
+    std::unordered_map<std::string, uint32_t> nameIndex;   //Name to its index in names
+    std::vector<replayEvent> events;
+    std::vector<subscriber> subscribers;
+    std::atomic<bool> stopRequested{false};
+
+    uint32_t _intern(const std::string& m_pvName);
+    bool _deliver(const replayEvent& event, const subscriber& sub, std::vector<char>& buffer);
+
+    public:
+    caReplay() {};
+    caReplay(std::string m_path) {load(m_path);};
+
+    //Append the events of a file; may be called for several files
+    void load(std::string m_path);
+    std::size_t get_event_count() {return events.size();};
+
+    void add_monitor(std::string m_pvName, void* usr, void (*callback)(struct event_handler_args args),
+                     chtype type = DBR_DOUBLE);
+    void remove_monitor(std::string m_pvName);
+
+    //speed 1.0 plays in real time, 10.0 ten times faster, 0 as fast as possible
+    replayStats run(double speed = 1.0);
+    //Ask a run on another thread to return after the current event
+    void stop() {stopRequested = true;};
+};
+} // namespace epics
+#endif
@@ -0,0 +1,167 @@
+#ifndef CASIMTRANSPORT_H
+#define CASIMTRANSPORT_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <random>
+#include <chrono>
+#include <functional>
+#include <condition_variable>
+#include <cstdint>
+
+#include "caTransport.h"
+
+namespace epics {
+
+struct simConfig {
+    double latency = 0.0;           //Seconds from request to reply (connects, gets, puts, monitor events)
+    double jitter = 0.0;            //Uniformly distributed extra latency in [0, jitter) seconds
+    double failure_rate = 0.0;      //Probability that a get or put fails
+    bool auto_create = true;        //Unknown names connect as scalar DBR_DOUBLE PVs
+    unsigned seed = 1;
+};
+
+/*
+In-process simulation of a Channel Access server and client. PVs live in memory,
+replies are delayed by the configured latency and jitter, and failures can be injected
+randomly or by disconnecting a PV. Array filter names ("wf.[first:last]" or
+"wf.VAL[first:last]") read a window of a defined PV, like the IOC's arr filter. Callbacks (connection, get/put completion, monitor
+events) run on a worker thread, like CA with preemptive callbacks enabled. With zero
+latency it measures the overhead of this library alone.
+*/
+class caSimTransport : public caTransport {
+    private:
+    typedef std::chrono::steady_clock clock;
+
+    struct simPV {
+        std::string name;
+        chtype type = DBR_DOUBLE;
+        unsigned long count = 1;            //Allocated elements (NELM)
+        std::vector<double> values;         //Valid elements (NORD)
+        std::string text;
+        epicsTimeStamp stamp = {0, 0};
+        bool connected = true;
+        double update_rate = 0.0;
+        std::vector<uint64_t> subscriptions;
+    };
+
+    struct simChannel {
+        uint64_t id;
+        std::string name;
+        simPV* pv = nullptr;
+        caCh* conn_callback = nullptr;
+        void* puser = nullptr;
+        clock::time_point connectAt;
+        //Window of an array filter channel such as "wf.[first:last]"
+        unsigned long first = 0;
+        unsigned long last = ~0UL;
+    };
+
+    struct simSubscription {
+        uint64_t id;
+        uint64_t channel;
+        chtype type;
+        unsigned long count;
+        long mask;
+        caEventCallBackFunc* callback;
+        void* usr;
+    };
+
+    struct pendingGet {
+        uint64_t channel;
+        chtype type;
+        unsigned long count;
+        void* value;
+    };
+
+    simConfig config;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::thread worker;
+    bool running = false;
+    bool inCallback = false;            //The worker is running a task with the mutex released
+    std::condition_variable callbackDone;
+    std::mt19937_64 rng;
+    uint64_t nextId = 1;
+
+    std::map<std::string, simPV*> pvs;
+    std::map<uint64_t, simChannel*> channels;
+    std::map<uint64_t, simSubscription*> subscriptions;
+    std::multimap<clock::time_point, std::function<void()>> tasks;
+    std::map<std::string, clock::time_point> nextUpdate;
+    int contexts = 0;
+
+    std::vector<pendingGet> pendingGets;
+    clock::time_point pendingDue;
+    bool pendingFailure = false;
+
+    caExceptionHandler* exceptionHandler = nullptr;
+    void* exceptionUsr = nullptr;
+
+    void _run();
+    void _wait_callback(std::unique_lock<std::mutex>& lock);
+    void _schedule(clock::time_point due, std::function<void()> task);
+    clock::time_point _due();
+    bool _fail();
+    simChannel* _channel(chid channel);
+    bool _connected(simChannel* channel);
+    void _changed(simPV* pv);
+    void _deliver(uint64_t subscription);
+    void _set_connected(std::string m_name, bool m_connected);
+    static void _stamp(simPV* pv);
+    static unsigned long _visible(const simChannel* channel, unsigned long count);
+    static int _encode(const simPV& pv, chtype type, unsigned long count, void* value, unsigned long first = 0);
+    static int _decode(simPV& pv, chtype type, unsigned long count, const void* value);
+
+    public:
+    caSimTransport(simConfig m_config = simConfig());
+    ~caSimTransport();
+
+    void set_config(simConfig m_config);
+
+    //Define a PV. count elements of the given DBR type, all set to initial.
+    void add_pv(std::string m_name, chtype type = DBR_DOUBLE, unsigned long count = 1, double initial = 0.0);
+    void set_value(std::string m_name, std::vector<double> m_values);
+    std::vector<double> get_value(std::string m_name);
+    //Change the PV by +1 per element at this rate and post monitor events; 0 stops it
+    void set_update_rate(std::string m_name, double hz);
+    //Failure injection: drop and restore the connection of a PV
+    void disconnect(std::string m_name);
+    void reconnect(std::string m_name);
+
+    int context_create(enum ca_preemptive_callback_select select) override;
+    void context_destroy() override;
+    struct ca_client_context* current_context() override;
+    int attach_context(struct ca_client_context* context) override;
+    void detach_context() override;
+
+    int create_channel(const char* name, caCh* conn_callback, void* puser, unsigned priority, chid* channel) override;
+    int clear_channel(chid channel) override;
+
+    int array_get(chtype type, unsigned long count, chid channel, void* value) override;
+    int array_get_callback(chtype type, unsigned long count, chid channel,
+                           caEventCallBackFunc* callback, void* usr) override;
+    int array_put(chtype type, unsigned long count, chid channel, const void* value) override;
+    int array_put_callback(chtype type, unsigned long count, chid channel, const void* value,
+                           caEventCallBackFunc* callback, void* usr) override;
+
+    int create_subscription(chtype type, unsigned long count, chid channel, long mask,
+                            caEventCallBackFunc* callback, void* usr, evid* monitor) override;
+    int clear_subscription(evid monitor) override;
+
+    int pend_io(double timeout) override;
+    int pend_event(double timeout) override;
+    int flush_io() override;
+    int add_exception_event(caExceptionHandler* handler, void* usr) override;
+
+    chtype field_type(chid channel) override;
+    unsigned long element_count(chid channel) override;
+    enum channel_state state(chid channel) override;
+    const char* name(chid channel) override;
+    void* puser(chid channel) override;
+};
+} // namespace epics
+#endif
@@ -0,0 +1,72 @@
+#ifndef CASNAPSHOT_H
+#define CASNAPSHOT_H
+
+#include <string>
+#include <cstring>
+#include <cstddef>
+#include <type_traits>
+
+#include <cadef.h>
+#include <db_access.h>
+
+namespace epics {
+
+class PV;
+
+//The DBR_TIME_ type requested for a member of a given C++ type, and the value type it
+//carries. The IOC converts from the native type, so the member type decides the request.
+template<typename TypeValue> struct snapshotType;
+template<> struct snapshotType<double> {typedef dbr_double_t wire; static constexpr chtype type = DBR_TIME_DOUBLE;};
+template<> struct snapshotType<float> {typedef dbr_float_t wire; static constexpr chtype type = DBR_TIME_FLOAT;};
+template<> struct snapshotType<short> {typedef dbr_short_t wire; static constexpr chtype type = DBR_TIME_SHORT;};
+template<> struct snapshotType<unsigned short> {typedef dbr_enum_t wire; static constexpr chtype type = DBR_TIME_ENUM;};
+template<> struct snapshotType<char> {typedef dbr_char_t wire; static constexpr chtype type = DBR_TIME_CHAR;};
+template<> struct snapshotType<unsigned char> {typedef dbr_char_t wire; static constexpr chtype type = DBR_TIME_CHAR;};
+template<> struct snapshotType<int> {typedef dbr_long_t wire; static constexpr chtype type = DBR_TIME_LONG;};
+template<> struct snapshotType<long> {typedef dbr_long_t wire; static constexpr chtype type = DBR_TIME_LONG;};
+template<> struct snapshotType<std::string> {typedef dbr_string_t wire; static constexpr chtype type = DBR_TIME_STRING;};
+
+//Binds one struct member, and optionally a member for its timestamp, to a PV field name
+template<typename Struct, typename TypeValue>
+struct snapshotField {
+    const char* field;
+    TypeValue Struct::* member;
+    epicsTimeStamp Struct::* stamp;
+};
+
+template<typename Struct, typename TypeValue>
+snapshotField<Struct, TypeValue> snapshot_field(const char* m_field, TypeValue Struct::* m_member,
+                                                epicsTimeStamp Struct::* m_stamp = nullptr) {
+    return snapshotField<Struct, TypeValue>{m_field, m_member, m_stamp};
+}
+
+//Declares the bindings of a struct for EpicsProxy::snapshot, e.g.
+//    EPICS_SNAPSHOT_FIELDS(snapshot_field("m1.RBV", &AxisState::position, &AxisState::positionTime),
+//                          snapshot_field("m1.DMOV", &AxisState::done))
+#define EPICS_SNAPSHOT_FIELDS(...) \
+    static auto snapshot_fields() {return std::make_tuple(__VA_ARGS__);}
+
+//One get of a snapshot. The buffer holds any DBR_TIME_ structure of one element.
+struct snapshotRequest {
+    PV* pv = nullptr;
+    chtype type = DBR_TIME_DOUBLE;
+    alignas(struct dbr_time_double) char buffer[sizeof(struct dbr_time_string)];
+};
+
+template<typename Struct, typename TypeValue>
+void snapshot_unpack(Struct& m_struct, const snapshotField<Struct, TypeValue>& m_field, const snapshotRequest& m_request) {
+    const void* value = dbr_value_ptr(m_request.buffer, m_request.type);
+    if constexpr (std::is_same_v<TypeValue, std::string>) {
+        m_struct.*m_field.member = std::string(static_cast<const char*>(value));
+    } else {
+        typename snapshotType<TypeValue>::wire m_wire;
+        std::memcpy(&m_wire, value, sizeof(m_wire));
+        m_struct.*m_field.member = static_cast<TypeValue>(m_wire);
+    }
+    if (m_field.stamp != nullptr) {
+        //All DBR_TIME_ structures start with status, severity and stamp
+        m_struct.*m_field.stamp = reinterpret_cast<const struct dbr_time_double*>(m_request.buffer)->stamp;
+    }
+}
+} // namespace epics
+#endif
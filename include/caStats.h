@@ -0,0 +1,50 @@
+#ifndef CASTATS_H
+#define CASTATS_H
+
+#include <atomic>
+#include <cstdint>
+
+namespace epics {
+
+//Point-in-time copy of a caCounters
+struct counterSnapshot {
+    uint64_t gets = 0;
+    uint64_t puts = 0;
+    uint64_t monitor_events = 0;
+    uint64_t bytes_received = 0;    //Element count times DBR size of gets and monitor events
+    uint64_t bytes_sent = 0;        //Element count times DBR size of puts
+    uint64_t timeouts = 0;
+    uint64_t disconnects = 0;
+    uint64_t exceptions = 0;        //CA exceptions reported for the channel
+
+    counterSnapshot& operator+=(const counterSnapshot& other);
+};
+
+//A counter on its own cache line, so threads updating neighbouring counters do not contend
+struct alignas(64) paddedCounter {
+    std::atomic<uint64_t> value{0};
+
+    void add(uint64_t n = 1) {value.fetch_add(n, std::memory_order_relaxed);};
+    uint64_t load() const {return value.load(std::memory_order_relaxed);};
+};
+
+/*
+Cumulative operation counters of one PV. Updated from the calling thread and from CA
+callback threads with relaxed atomic adds; counters only grow, so a scraper can take
+differences between snapshots.
+*/
+class caCounters {
+    public:
+    paddedCounter gets;
+    paddedCounter puts;
+    paddedCounter monitorEvents;
+    paddedCounter bytesReceived;
+    paddedCounter bytesSent;
+    paddedCounter timeouts;
+    paddedCounter disconnects;
+    paddedCounter exceptions;
+
+    counterSnapshot snapshot() const;
+};
+} // namespace epics
+#endif
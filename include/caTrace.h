@@ -0,0 +1,169 @@
+#ifndef CATRACE_H
+#define CATRACE_H
+
+#include <string>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+
+#include <cadef.h>
+#include <db_access.h>
+
+#include "caTransport.h"
+
+namespace epics {
+
+//One completed span. name points to a string literal; pv is copied so the
+//event stays valid after the PV is destroyed.
+struct traceEvent {
+    const char* name;
+    uint64_t begin_ns;
+    uint64_t end_ns;
+    int status;
+    char pv[60];
+};
+
+/*
+Span buffer of one thread. Only the owning thread appends, publishing each event with
+a release store of size, so appending never locks. When the buffer is full further
+events are counted as dropped. A buffer whose generation is older than the tracer's
+is reset by its owner on the next append, which is how caTracer::start() clears old
+events without touching other threads' buffers. The owner sets exited as it ends, after
+which the buffer can be freed by caTracer::release_exited().
+*/
+struct traceBuffer {
+    std::unique_ptr<traceEvent[]> events;
+    std::size_t capacity = 0;
+    std::atomic<std::size_t> size{0};
+    std::atomic<uint64_t> dropped{0};
+    std::atomic<uint64_t> generation{0};
+    std::atomic<bool> exited{false};
+    uint32_t tid = 0;
+};
+
+/*
+Process-wide span tracer. While started, PV operations and every call made through a
+caTracingTransport are recorded as begin/end spans into per-thread buffers.
+write_chrome_trace() dumps them as Chrome trace JSON, which loads in Perfetto
+(ui.perfetto.dev) or chrome://tracing. Building with -DEPICS_PROXY_NO_TRACE compiles
+the spans out.
+*/
+class caTracer {
+    public:
+    //Start a new trace, discarding earlier events; each thread keeps up to m_capacity spans
+    static void start(std::size_t m_capacity = 65536);
+    static void stop();
+    static bool enabled() {return active.load(std::memory_order_relaxed);};
+
+    //Write the events of the current trace; returns the number of spans written
+    static std::size_t write_chrome_trace(std::string m_path);
+    static uint64_t get_dropped();
+    //Free the buffers of threads that have exited, with their events; returns how many
+    static std::size_t release_exited();
+
+    static uint64_t now();
+    static void record(const char* m_name, const char* m_pv, uint64_t m_begin, uint64_t m_end, int m_status);
+
+    private:
+    static std::atomic<bool> active;
+    static traceBuffer* _buffer();
+};
+
+//Records one span from construction to destruction
+class caTraceSpan {
+    private:
+#ifndef EPICS_PROXY_NO_TRACE
+    const char* name;
+    const char* pv;
+    uint64_t begin = 0;
+    int status = ECA_NORMAL;
+#endif
+
+    public:
+    caTraceSpan(const char* m_name, const char* m_pv) {
+#ifndef EPICS_PROXY_NO_TRACE
+        name = m_name;
+        pv = m_pv;
+        if (caTracer::enabled()) {
+            begin = caTracer::now();
+        }
+#else
+        (void)m_name;
+        (void)m_pv;
+#endif
+    }
+    ~caTraceSpan() {
+#ifndef EPICS_PROXY_NO_TRACE
+        if (begin != 0 && caTracer::enabled()) {
+            caTracer::record(name, pv, begin, caTracer::now(), status);
+        }
+#endif
+    }
+    caTraceSpan(const caTraceSpan&) = delete;
+    caTraceSpan& operator=(const caTraceSpan&) = delete;
+
+    //ECA_ status code attached to the span. The first failure is kept, so an operation
+    //can report each of its CA calls in turn.
+    void set_status(int m_status) {
+#ifndef EPICS_PROXY_NO_TRACE
+        if (status == ECA_NORMAL) {
+            status = m_status;
+        }
+#else
+        (void)m_status;
+#endif
+    }
+};
+
+/*
+Transport decorator that records a span, with the channel name and returned status,
+for every call that can block or reach the network. Lookups such as field_type pass
+straight through. Other threads may be inside a decorator at any time, so decorators
+are made by wrap() and live as long as the process; with the tracer stopped one only
+costs the forwarding call.
+*/
+class caTracingTransport : public caTransport {
+    private:
+    caTransport* inner;
+
+    caTracingTransport(caTransport* m_inner) {inner = m_inner;};
+
+    public:
+    //The decorator of m_inner, made on first use; m_inner itself if it is one
+    static caTracingTransport* wrap(caTransport* m_inner);
+    caTransport* get_inner() {return inner;};
+
+    int context_create(enum ca_preemptive_callback_select select) override;
+    void context_destroy() override;
+    struct ca_client_context* current_context() override;
+    int attach_context(struct ca_client_context* context) override;
+    void detach_context() override;
+
+    int create_channel(const char* name, caCh* conn_callback, void* puser, unsigned priority, chid* channel) override;
+    int clear_channel(chid channel) override;
+
+    int array_get(chtype type, unsigned long count, chid channel, void* value) override;
+    int array_get_callback(chtype type, unsigned long count, chid channel,
+                           caEventCallBackFunc* callback, void* usr) override;
+    int array_put(chtype type, unsigned long count, chid channel, const void* value) override;
+    int array_put_callback(chtype type, unsigned long count, chid channel, const void* value,
+                           caEventCallBackFunc* callback, void* usr) override;
+
+    int create_subscription(chtype type, unsigned long count, chid channel, long mask,
+                            caEventCallBackFunc* callback, void* usr, evid* monitor) override;
+    int clear_subscription(evid monitor) override;
+
+    int pend_io(double timeout) override;
+    int pend_event(double timeout) override;
+    int flush_io() override;
+    int add_exception_event(caExceptionHandler* handler, void* usr) override;
+
+    chtype field_type(chid channel) override;
+    unsigned long element_count(chid channel) override;
+    enum channel_state state(chid channel) override;
+    const char* name(chid channel) override;
+    void* puser(chid channel) override;
+};
+} // namespace epics
+#endif
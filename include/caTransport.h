@@ -0,0 +1,97 @@
+#ifndef CATRANSPORT_H
+#define CATRANSPORT_H
+
+#include <cadef.h>
+#include <db_access.h>
+
+namespace epics {
+
+/*
+The subset of the Channel Access client API used by this library. Every call in PV and
+its helpers goes through the current transport, so a process can run against a real
+IOC (caChannelAccess) or an in-process simulation (caSimTransport) without code changes.
+Methods mirror the ca_* functions of the same name and return ECA_ status codes, so
+callers keep using SEVCHK.
+*/
+class caTransport {
+    public:
+    virtual ~caTransport() {};
+
+    virtual int context_create(enum ca_preemptive_callback_select select) = 0;
+    virtual void context_destroy() = 0;
+    virtual struct ca_client_context* current_context() = 0;
+    virtual int attach_context(struct ca_client_context* context) = 0;
+    virtual void detach_context() = 0;
+
+    virtual int create_channel(const char* name, caCh* conn_callback, void* puser, unsigned priority, chid* channel) = 0;
+    virtual int clear_channel(chid channel) = 0;
+
+    virtual int array_get(chtype type, unsigned long count, chid channel, void* value) = 0;
+    virtual int array_get_callback(chtype type, unsigned long count, chid channel,
+                                   caEventCallBackFunc* callback, void* usr) = 0;
+    virtual int array_put(chtype type, unsigned long count, chid channel, const void* value) = 0;
+    virtual int array_put_callback(chtype type, unsigned long count, chid channel, const void* value,
+                                   caEventCallBackFunc* callback, void* usr) = 0;
+
+    virtual int create_subscription(chtype type, unsigned long count, chid channel, long mask,
+                                    caEventCallBackFunc* callback, void* usr, evid* monitor) = 0;
+    virtual int clear_subscription(evid monitor) = 0;
+
+    virtual int pend_io(double timeout) = 0;
+    virtual int pend_event(double timeout) = 0;
+    virtual int flush_io() = 0;
+    virtual int add_exception_event(caExceptionHandler* handler, void* usr) = 0;
+
+    virtual chtype field_type(chid channel) = 0;
+    virtual unsigned long element_count(chid channel) = 0;
+    virtual enum channel_state state(chid channel) = 0;
+    virtual const char* name(chid channel) = 0;
+    virtual void* puser(chid channel) = 0;
+};
+
+//The real Channel Access client library
+class caChannelAccess : public caTransport {
+    public:
+    int context_create(enum ca_preemptive_callback_select select) override;
+    void context_destroy() override;
+    struct ca_client_context* current_context() override;
+    int attach_context(struct ca_client_context* context) override;
+    void detach_context() override;
+
+    int create_channel(const char* name, caCh* conn_callback, void* puser, unsigned priority, chid* channel) override;
+    int clear_channel(chid channel) override;
+
+    int array_get(chtype type, unsigned long count, chid channel, void* value) override;
+    int array_get_callback(chtype type, unsigned long count, chid channel,
+                           caEventCallBackFunc* callback, void* usr) override;
+    int array_put(chtype type, unsigned long count, chid channel, const void* value) override;
+    int array_put_callback(chtype type, unsigned long count, chid channel, const void* value,
+                           caEventCallBackFunc* callback, void* usr) override;
+
+    int create_subscription(chtype type, unsigned long count, chid channel, long mask,
+                            caEventCallBackFunc* callback, void* usr, evid* monitor) override;
+    int clear_subscription(evid monitor) override;
+
+    int pend_io(double timeout) override;
+    int pend_event(double timeout) override;
+    int flush_io() override;
+    int add_exception_event(caExceptionHandler* handler, void* usr) override;
+
+    chtype field_type(chid channel) override;
+    unsigned long element_count(chid channel) override;
+    enum channel_state state(chid channel) override;
+    const char* name(chid channel) override;
+    void* puser(chid channel) override;
+};
+
+//Transport used by the library. Defaults to caChannelAccess; caContext sets it.
+caTransport* get_transport();
+void set_transport(caTransport* m_transport);
+
+//Used by caContext. The transport is process-wide, so every live context must use the
+//same one: the first context installs it, the last one restores the transport that was
+//current before. Binding a different transport while contexts are alive throws.
+void bind_transport(caTransport* m_transport);
+void unbind_transport();
+} // namespace epics
+#endif
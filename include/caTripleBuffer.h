@@ -0,0 +1,63 @@
+#ifndef CATRIPLEBUFFER_H
+#define CATRIPLEBUFFER_H
+
+#include <vector>
+#include <atomic>
+#include <cstdint>
+
+#include <cadef.h>
+#include <db_access.h>
+
+namespace epics {
+
+//One waveform as delivered by a monitor event, in its plain DBR type
+struct arrayFrame {
+    chtype type = DBR_DOUBLE;
+    unsigned long count = 0;        //Valid elements
+    uint64_t sequence = 0;          //Number of the event, from 1; 0 before the first event
+    std::vector<char> data;         //Room for the full length, allocated up front
+
+    template<typename Wire>
+    const Wire* values() const {return reinterpret_cast<const Wire*>(data.data());}
+};
+
+/*
+Three frames handed between one writer (the CA callback thread) and one reader without
+locks. The writer fills its back frame and swaps it with the middle one in a single
+atomic exchange that also marks the middle as fresh. The reader swaps a fresh middle
+with its front frame and reads the front in place until it asks again. Neither side
+ever waits for the other: a fast writer overwrites frames the reader never saw (counted
+as dropped), a fast reader keeps getting the same newest frame.
+*/
+class caTripleBuffer {
+    private:
+    static constexpr unsigned FRESH = 4;
+
+    arrayFrame frames[3];
+    std::atomic<unsigned> middle{1};    //Index of the middle frame, ORed with FRESH when unread
+    unsigned back = 0;                  //Writer only
+    unsigned front = 2;                 //Reader only
+    uint64_t published = 0;             //Writer only
+    std::atomic<uint64_t> dropped{0};
+
+    public:
+    caTripleBuffer(chtype m_type, unsigned long m_capacity);
+    caTripleBuffer(const caTripleBuffer&) = delete;
+    caTripleBuffer& operator=(const caTripleBuffer&) = delete;
+
+    chtype get_type() {return frames[0].type;};
+    unsigned long get_capacity() {return static_cast<unsigned long>(frames[0].data.size() / dbr_value_size[frames[0].type]);};
+
+    //Writer: copy m_count elements (clamped to the capacity) into the back frame and publish it
+    void publish(const void* m_values, unsigned long m_count);
+
+    //Reader: the newest published frame, valid until the reader's next call
+    const arrayFrame* latest();
+    //Reader: true when a frame newer than the one latest() last returned is waiting
+    bool has_new() {return (middle.load(std::memory_order_acquire) & FRESH) != 0;};
+
+    //Frames replaced before the reader took them
+    uint64_t get_dropped() {return dropped.load(std::memory_order_relaxed);};
+};
+} // namespace epics
+#endif
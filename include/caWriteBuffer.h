@@ -0,0 +1,63 @@
+#ifndef CAWRITEBUFFER_H
+#define CAWRITEBUFFER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+
+#include <cadef.h>
+
+#include "caTransport.h"
+
+namespace epics {
+
+//Thresholds that trigger an automatic ca_flush_io in buffered write mode.
+//A value of 0 disables that threshold. With all thresholds disabled, queued puts
+//are only sent on an explicit flush() or when the CA send buffer fills.
+struct flushPolicy {
+    unsigned long max_count = 0;    //Number of queued puts
+    std::size_t max_bytes = 0;      //Payload bytes of queued puts (element count * DBR size)
+    unsigned long max_usec = 0;     //Age in microseconds of the oldest queued put
+};
+
+/*
+Accounting for fire-and-forget puts. PVs holding a pointer to a caWriteBuffer
+issue ca_put without waiting in ca_pend_io and report the queued request here.
+The buffer flushes the CA send queue once a flushPolicy threshold is reached.
+With max_usec set, a thread attached to the owner's CA context flushes puts that
+reach that age, so a stream that stops is still sent without an explicit flush().
+*/
+class caWriteBuffer {
+    private:
+    std::mutex mutex;
+    std::condition_variable changed;    //Puts queued on an empty buffer, policy changed or stopping
+    flushPolicy policy;
+    unsigned long queuedCount = 0;
+    std::size_t queuedBytes = 0;
+    std::chrono::steady_clock::time_point firstQueued;
+    struct ca_client_context* context;
+    std::thread ageThread;
+    bool stopping = false;
+
+    void _flush();
+    void _start_age_thread();
+    void _age_loop();
+
+    public:
+    caWriteBuffer(flushPolicy m_policy = flushPolicy(), struct ca_client_context* m_context = nullptr);
+    ~caWriteBuffer();
+
+    void set_policy(flushPolicy m_policy);
+    flushPolicy get_policy();
+
+    //Record a put of the given payload size and flush if the policy requires it
+    void queued(std::size_t bytes);
+    void flush();
+
+    unsigned long get_queued_count();
+    std::size_t get_queued_bytes();
+};
+} // namespace epics
+#endif
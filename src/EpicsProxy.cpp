@@ -39,16 +39,52 @@ void EpicsProxy::init(std::string m_deviceName,
     setenv("EPICS_CA_MAX_ARRAY_BYTES", m_caConfig.ca_max_array_bytes, 1);
     setenv("EPICS_TS_MIN_WEST", m_caConfig.ts_min_west, 1);
 
-    caContext_ptr = new caContext();
+    caContext_ptr = new caContext(m_caConfig.transport);
+    SEVCHK(get_transport()->add_exception_event(exception_callback, this), "Failed to install exception handler");
     //Set the device name
     deviceName = m_deviceName;
+    lazyChannels = m_caConfig.lazy_channels;
 
     //Create the PVs
-    for (auto m_pvName : m_pvNames) {
-        PV* m_pv = new PV(deviceName, m_pvName);
-        pvList.push_back(m_pv);
+    pvList.reserve(m_pvNames.size());
+    for (auto& m_pvName : m_pvNames) {
+        _add_pv(new PV(deviceName, m_pvName, 20, lazyChannels));
+    }
+    //Lazy PVs connect on first use
+    if (lazyChannels) {
+        return;
+    }
+    _wait_connected(0, "Failed to create PVs");
+}
+
+//Channels have connection handlers, so wait for them here rather than in ca_pend_io
+void EpicsProxy::_wait_connected(std::size_t m_first, const char* m_message) {
+    SEVCHK(get_transport()->flush_io(), m_message);
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    for (std::size_t i = m_first; i < pvList.size(); i++) {
+        double remaining = std::chrono::duration<double>(deadline - std::chrono::steady_clock::now()).count();
+        if (!pvList[i]->wait_connected(std::max(remaining, 0.0))) {
+            SEVCHK(ECA_TIMEOUT, m_message);
+        }
     }
-    SEVCHK(ca_pend_io(5.0), "Failed to create PVs");
+}
+
+void EpicsProxy::_create_group(std::string m_recordName, const char* const* m_fields, std::size_t m_count, PV** m_pvs) {
+    std::size_t first = pvList.size();
+    pvList.reserve(first + m_count);
+    for (std::size_t i = 0; i < m_count; i++) {
+        m_pvs[i] = new PV(deviceName, m_recordName + m_fields[i], 20, lazyChannels);
+        _add_pv(m_pvs[i]);
+    }
+    if (!lazyChannels) {
+        _wait_connected(first, ("Failed to create record " + deviceName + m_recordName).c_str());
+    }
+}
+
+caImage EpicsProxy::create_image(std::string m_pluginName) {
+    std::array<PV*, caImage::SHAPE_FIELDS + 1> m_pvs;
+    _create_group(m_pluginName, caImage::fieldNames.data(), m_pvs.size(), m_pvs.data());
+    return caImage(deviceName + m_pluginName, m_pvs);
 }
 
 EpicsProxy::EpicsProxy(std::string name) {
@@ -57,42 +93,355 @@ EpicsProxy::EpicsProxy(std::string name) {
 }
 
 EpicsProxy::~EpicsProxy() {
-    //Destruct the contents of all pointers in pvList
+    //Stop prewarming and recording before the channels are cleared
+    stop_prewarm();
+    stop_recorder();
+
+    //Destruct the contents of all pointers in pvList; pooled PVs go with their pool
     for (PV* m_pv : pvList) {
-        delete m_pv;
+        bool pooled = false;
+        for (caPVPool* m_pool : pvPools) {
+            pooled = pooled || m_pool->owns(m_pv);
+        }
+        if (!pooled) {
+            delete m_pv;
+        }
     }
     pvList.clear();
+    pvIndex.clear();
+    for (caPVPool* m_pool : pvPools) {
+        delete m_pool;
+    }
+    pvPools.clear();
 
-    //Destroy the EPICS context
+    //Send any queued puts before the context goes away
+    delete writeBuffer_ptr;
+    writeBuffer_ptr = nullptr;
+
+    //Destroy the EPICS context. A tracing wrapper it was using stays for other threads.
     destroy_context();
+    if (tracingTransport_ptr != nullptr) {
+        caTracer::stop();
+        tracingTransport_ptr = nullptr;
+    }
 }
 
 PV* EpicsProxy::create_PV(std::string m_fullName) {
-        PV* m_pv = new PV("", m_fullName);
-        pvList.push_back(m_pv);
-        return pvList.back();
+        PV* m_pv = new PV("", m_fullName, 20, lazyChannels);
+        _add_pv(m_pv);
+        return m_pv;
     }
 
-void EpicsProxy::add_monitor(std::string m_fieldName, EpicsProxy* proxy, void (*callback)(struct event_handler_args args)) {
+//The first PV with a given field name wins, as with the linear lookup this replaced
+void EpicsProxy::_add_pv(PV* m_pv) {
+    m_pv->set_write_buffer(writeBuffer_ptr);
+    pvList.push_back(m_pv);
+    pvIndex.emplace(std::string_view(m_pv->fieldName), m_pv);
+}
+
+manifestReport EpicsProxy::load_manifest(std::string m_path, double m_timeout) {
+    typedef std::chrono::steady_clock clock;
+    auto ms_since = [](clock::time_point m_start) {
+        return std::chrono::duration<double, std::milli>(clock::now() - m_start).count();
+    };
+    manifestReport m_report;
+
+    auto start = clock::now();
+    caManifest m_manifest(m_path);
+    const std::vector<manifestEntry>& entries = m_manifest.get_entries();
+    m_report.pvs = entries.size();
+    m_report.duplicates = m_manifest.get_duplicates();
+    m_report.parse_ms = ms_since(start);
+
+    start = clock::now();
+    caPVPool* m_pool = new caPVPool(entries.size());
+    pvPools.push_back(m_pool);
+    pvList.reserve(pvList.size() + entries.size());
+    pvIndex.reserve(pvIndex.size() + entries.size());
+    std::string m_name;
+    for (const manifestEntry& entry : entries) {
+        m_name.assign(entry.name);
+        _add_pv(m_pool->create(deviceName, m_name, entry.priority, lazyChannels));
+    }
+    m_report.create_ms = ms_since(start);
+    if (lazyChannels) {
+        return m_report;
+    }
+
+    start = clock::now();
+    SEVCHK(get_transport()->flush_io(), "Failed to load manifest");
+    m_report.flush_ms = ms_since(start);
+
+    if (m_timeout <= 0.0) {
+        return m_report;
+    }
+    start = clock::now();
+    auto deadline = clock::now() + std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(m_timeout));
+    std::size_t first = pvList.size() - entries.size();
+    for (std::size_t i = 0; i < entries.size(); i++) {
+        PV* m_pv = pvList[first + i];
+        double remaining = std::chrono::duration<double>(deadline - clock::now()).count();
+        if (!m_pv->wait_connected(std::max(remaining, 0.0))) {
+            m_report.not_connected.push_back(m_pv->get_full_name());
+            continue;
+        }
+        m_report.connected++;
+        if (entries[i].type != TYPENOTCONN && m_pv->get_data_type() != entries[i].type) {
+            m_report.type_mismatches.push_back(m_pv->get_full_name());
+        }
+    }
+    m_report.connect_ms = ms_since(start);
+    return m_report;
+}
+
+void EpicsProxy::start_prewarm(double m_channelsPerSecond) {
+    if (m_channelsPerSecond <= 0.0) {
+        throw std::runtime_error("Prewarm rate must be positive");
+    }
+    stop_prewarm();
+    prewarmStop = false;
+    //The thread works on a copy, so PVs added later are left to connect on first use
+    std::vector<PV*> m_pvs = pvList;
+    struct ca_client_context* m_context = get_context();
+    prewarmThread = std::thread([this, m_pvs, m_context, m_channelsPerSecond]() {
+        SEVCHK(get_transport()->attach_context(m_context), "Failed to attach prewarm thread");
+        auto interval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(1.0 / m_channelsPerSecond));
+        auto next = std::chrono::steady_clock::now();
+        for (PV* m_pv : m_pvs) {
+            if (prewarmStop) {
+                break;
+            }
+            if (m_pv->has_channel()) {
+                continue;
+            }
+            std::this_thread::sleep_until(next);
+            next += interval;
+            m_pv->prewarm();
+            get_transport()->flush_io();
+        }
+        get_transport()->detach_context();
+    });
+}
+
+void EpicsProxy::stop_prewarm() {
+    prewarmStop = true;
+    if (prewarmThread.joinable()) {
+        prewarmThread.join();
+    }
+}
+
+std::size_t EpicsProxy::get_created_channels() {
+    std::size_t m_created = 0;
     for (PV* m_pv : pvList) {
-        if (m_pv->get_name() == m_fieldName) {
-            m_pv->add_monitor(proxy, callback);
-            return;
+        m_created += m_pv->has_channel() ? 1 : 0;
+    }
+    return m_created;
+}
+
+//All gets are queued before one ca_pend_io, so the batch costs a single round trip
+void EpicsProxy::_snapshot(snapshotRequest* m_requests, std::size_t m_count) {
+    caTraceSpan span("snapshot", deviceName.c_str());
+    for (std::size_t i = 0; i < m_count; i++) {
+        PV* m_pv = m_requests[i].pv;
+        m_pv->_ensure_channel(true);
+        int m_status = get_transport()->array_get(m_requests[i].type, 1, m_pv->channel, m_requests[i].buffer);
+        span.set_status(m_status);
+        SEVCHK(m_status, ("Failed to get value from PV " + m_pv->pvName).c_str());
+    }
+    uint64_t start = caLatencyStats::now();
+    int status = get_transport()->pend_io(5.0);
+    span.set_status(status);
+    for (std::size_t i = 0; i < m_count; i++) {
+        PV* m_pv = m_requests[i].pv;
+        if (status == ECA_TIMEOUT) {
+            m_pv->counters.timeouts.add();
+            continue;
         }
+        m_pv->latency.record(LATENCY_GET, start);
+        m_pv->counters.gets.add();
+        m_pv->counters.bytesReceived.add(dbr_size_n(m_requests[i].type, 1));
     }
-    throw std::runtime_error("PV " + m_fieldName + " not found");
+    SEVCHK(status, ("Failed to read snapshot of " + deviceName).c_str());
 }
 
-void EpicsProxy::remove_monitor(std::string m_fieldName) {
+//Tracing wraps the current transport so every CA call made by the library is recorded
+void EpicsProxy::start_trace(std::size_t m_perThreadEvents) {
+    if (tracingTransport_ptr == nullptr) {
+        tracingTransport_ptr = caTracingTransport::wrap(get_transport());
+        set_transport(tracingTransport_ptr);
+    }
+    caTracer::start(m_perThreadEvents);
+}
+
+//The wrapper is unhooked but not freed, since other threads may still be inside it
+std::size_t EpicsProxy::stop_trace(std::string m_path) {
+    caTracer::stop();
+    if (tracingTransport_ptr != nullptr) {
+        if (get_transport() == tracingTransport_ptr) {
+            set_transport(tracingTransport_ptr->get_inner());
+        }
+        tracingTransport_ptr = nullptr;
+    }
+    std::size_t written = caTracer::write_chrome_trace(m_path);
+    //Threads that have ended since the trace started would otherwise keep their buffers
+    caTracer::release_exited();
+    return written;
+}
+
+void EpicsProxy::exception_callback(struct exception_handler_args args) {
+    EpicsProxy* proxy = static_cast<EpicsProxy*>(args.usr);
+    std::string m_channel = "unknown channel";
+    PV* m_pv = args.chid != nullptr ? static_cast<PV*>(caChannelTable::first_user(args.chid)) : nullptr;
+    if (m_pv != nullptr) {
+        m_pv->count_exception();
+        m_channel = m_pv->get_full_name();
+    } else {
+        proxy->unattributedExceptions.add();
+    }
+    std::cerr << "CA exception status " << args.stat << " on " << m_channel << ": "
+              << (args.ctx != nullptr ? args.ctx : "") << std::endl;
+}
+
+proxyStats EpicsProxy::stats() {
+    proxyStats m_stats;
+    for (PV* m_pv : pvList) {
+        pvStats m_entry;
+        m_entry.name = m_pv->get_full_name();
+        m_entry.counters = m_pv->get_counters();
+        m_stats.total += m_entry.counters;
+        m_stats.pvs.push_back(m_entry);
+    }
+    m_stats.total.exceptions += unattributedExceptions.load();
+    return m_stats;
+}
+
+std::vector<pvLatency> EpicsProxy::latency_snapshot() {
+    std::vector<pvLatency> m_snapshot;
     for (PV* m_pv : pvList) {
-        if (m_pv->get_name() == m_fieldName) {
-            m_pv->remove_monitor();
-            return;
+        pvLatency m_entry;
+        m_entry.name = m_pv->get_full_name();
+        for (int op = 0; op < LATENCY_OP_COUNT; op++) {
+            m_entry.ops[op] = m_pv->get_latency(static_cast<latencyOp>(op));
         }
+        m_snapshot.push_back(m_entry);
+    }
+    return m_snapshot;
+}
+
+PV* EpicsProxy::get_pv(std::string m_fieldName) {
+    auto found = pvIndex.find(std::string_view(m_fieldName));
+    if (found != pvIndex.end()) {
+        return found->second;
     }
     throw std::runtime_error("PV " + m_fieldName + " not found");
 }
 
+void EpicsProxy::set_buffered_writes(bool enable, flushPolicy m_policy) {
+    if (enable) {
+        if (writeBuffer_ptr == nullptr) {
+            writeBuffer_ptr = new caWriteBuffer(m_policy, get_context());
+        } else {
+            writeBuffer_ptr->set_policy(m_policy);
+        }
+    } else if (writeBuffer_ptr != nullptr) {
+        //Detach the PVs first so no put is queued on a buffer being deleted
+        for (PV* m_pv : pvList) {
+            m_pv->set_write_buffer(nullptr);
+        }
+        delete writeBuffer_ptr;
+        writeBuffer_ptr = nullptr;
+        return;
+    }
+    for (PV* m_pv : pvList) {
+        m_pv->set_write_buffer(writeBuffer_ptr);
+    }
+}
+
+void EpicsProxy::flush() {
+    if (writeBuffer_ptr != nullptr) {
+        writeBuffer_ptr->flush();
+    } else {
+        SEVCHK(get_transport()->flush_io(), "Failed to flush puts");
+    }
+}
+
+void EpicsProxy::set_coalescing(std::string m_fieldName, bool enable) {
+    get_pv(m_fieldName)->set_coalescing(enable);
+}
+
+coalescingCounters EpicsProxy::get_coalescing_counters(std::string m_fieldName) {
+    return get_pv(m_fieldName)->get_coalescing_counters();
+}
+
+void EpicsProxy::set_chunking(std::string m_fieldName, bool enable, chunkConfig m_config) {
+    get_pv(m_fieldName)->set_chunking(enable, m_config);
+}
+
+std::vector<std::string> EpicsProxy::start_recorder(std::string m_path, std::vector<std::string> m_fieldNames, std::size_t m_capacity) {
+    if (recorder_ptr != nullptr) {
+        throw std::runtime_error("Recorder already running on " + recorder_ptr->get_path());
+    }
+    //Resolve every PV before creating the file so a bad name leaves nothing behind
+    std::vector<PV*> m_pvs;
+    std::vector<std::string> m_fullNames;
+    for (auto m_fieldName : m_fieldNames) {
+        PV* m_pv = get_pv(m_fieldName);
+        m_pvs.push_back(m_pv);
+        m_fullNames.push_back(m_pv->get_full_name());
+    }
+    recorder_ptr = new caRecorder(m_path, m_fullNames, m_capacity);
+    std::vector<std::string> m_skipped;
+    for (std::size_t i = 0; i < m_pvs.size(); i++) {
+        if (!recorder_ptr->add(m_pvs[i], static_cast<uint32_t>(i))) {
+            m_skipped.push_back(m_fieldNames[i]);
+        }
+    }
+    SEVCHK(get_transport()->flush_io(), "Failed to start recorder");
+    return m_skipped;
+}
+
+void EpicsProxy::stop_recorder() {
+    delete recorder_ptr;
+    recorder_ptr = nullptr;
+}
+
+void EpicsProxy::add_monitor(std::string m_fieldName, EpicsProxy* proxy, void (*callback)(struct event_handler_args args)) {
+    PV* m_pv = get_pv(m_fieldName);
+    if (replay_ptr != nullptr) {
+        //Replay in the type a live monitor would get; a PV never connected has only a set wire type
+        chtype m_type = m_pv->is_connected() ? m_pv->_wire_type() : m_pv->get_wire_type();
+        replay_ptr->add_monitor(m_pv->get_full_name(), proxy, callback, m_type != TYPENOTCONN ? m_type : DBR_DOUBLE);
+        return;
+    }
+    m_pv->add_monitor(proxy, callback);
+}
+
+caTripleBuffer* EpicsProxy::add_array_monitor(std::string m_fieldName) {
+    PV* m_pv = get_pv(m_fieldName);
+    if (replay_ptr != nullptr) {
+        throw std::runtime_error("PV " + m_pv->get_full_name() + " cannot have an array monitor during replay");
+    }
+    return m_pv->add_array_monitor();
+}
+
+caReduction* EpicsProxy::add_reduction(std::string m_fieldName, reductionCallback* m_callback, void* m_usr) {
+    PV* m_pv = get_pv(m_fieldName);
+    if (replay_ptr != nullptr) {
+        throw std::runtime_error("PV " + m_pv->get_full_name() + " cannot have a reduction during replay");
+    }
+    return m_pv->add_reduction(m_callback, m_usr);
+}
+
+void EpicsProxy::remove_monitor(std::string m_fieldName) {
+    PV* m_pv = get_pv(m_fieldName);
+    if (replay_ptr != nullptr) {
+        replay_ptr->remove_monitor(m_pv->get_full_name());
+        return;
+    }
+    m_pv->remove_monitor();
+}
+
 void EpicsProxy::write_pv(std::string m_fieldName, std::string type, std::any m_value) {
     //Check that the type is allowed and use the appropriate write function
     if (type == "double") {
@@ -117,18 +466,8 @@ void EpicsProxy::write_pv(std::string m_fieldName, std::string type, std::any m_
 }
 
 void EpicsProxy::write_pv(std::string m_fieldName, std::string m_value) {
-    //Check to see if the PV exists and get the field type
-    chtype field_type = NULL;
-    for (PV* m_pv : pvList) {
-        if (m_pv->get_name() == m_fieldName) {
-            field_type = m_pv->get_field_type();
-            break;
-        }
-    }
-    //Throw exception if field_type is NULL
-    if (field_type == NULL) {
-        throw std::runtime_error("PV " + m_fieldName + " not found");
-    }
+    //Get the field type, throws if the PV does not exist
+    chtype field_type = get_pv(m_fieldName)->get_field_type();
     //Cast m_value and call the appropriate write function based on the field type
     if (field_type == DBR_DOUBLE) {
         write_pv<double>(m_fieldName, std::stod(m_value));
@@ -152,34 +491,16 @@ void EpicsProxy::write_pv(std::string m_fieldName, std::string m_value) {
 
 template<typename TypeValue>
 void EpicsProxy::write_pv(std::string m_fieldName, TypeValue m_value) {
-    for (PV* m_pv : pvList) {
-        if (m_pv->get_name() == m_fieldName) {
-            m_pv->write<TypeValue>(m_value);
-            return;
-        }
-    }
-    throw std::runtime_error("PV " + m_fieldName + " not found");
+    get_pv(m_fieldName)->write<TypeValue>(m_value);
 }
 
 void EpicsProxy::write_pv_string(std::string m_fieldName, std::string m_value) {
-    for (PV* m_pv : pvList) {
-        if (m_pv->get_name() == m_fieldName) {
-            m_pv->write_string(m_value);
-            return;
-        }
-    }
-    throw std::runtime_error("PV " + m_fieldName + " not found");
+    get_pv(m_fieldName)->write_string(m_value);
 }
 
 template<typename TypeValue>
 void EpicsProxy::write_pv_array(std::string m_fieldName, std::vector<TypeValue> m_value) {
-    for (PV* m_pv : pvList) {
-        if (m_pv->get_name() == m_fieldName) {
-            m_pv->write_array<TypeValue>(m_value);
-            return;
-        }
-    }
-    throw std::runtime_error("PV " + m_fieldName + " not found");
+    get_pv(m_fieldName)->write_array<TypeValue>(m_value);
 }
 
 std::any EpicsProxy::read_pv(std::string m_fieldName, std::string type, bool as_string) {
@@ -236,31 +557,47 @@ std::any EpicsProxy::read_pv(std::string m_fieldName, std::string type, bool as_
 
 template<typename TypeValue>
 TypeValue EpicsProxy::read_pv(std::string m_fieldName) {
-    for (PV* m_pv : pvList) {
-        if (m_pv->get_name() == m_fieldName) {
-            return m_pv->read<TypeValue>();
-        }
-    }
-    throw std::runtime_error("PV " + m_fieldName + " not found");
+    return get_pv(m_fieldName)->read<TypeValue>();
 }
 
 std::string EpicsProxy::read_pv_string(std::string m_fieldName) {
-    for (PV* m_pv : pvList) {
-        if (m_pv->get_name() == m_fieldName) {
-            return m_pv->read_string();
-        }
-    }
-    throw std::runtime_error("PV " + m_fieldName + " not found");
+    return get_pv(m_fieldName)->read_string();
 }
 
 template<typename TypeValue>
 std::vector<TypeValue> EpicsProxy::read_pv_array(std::string m_fieldName) {
-    for (PV* m_pv : pvList) {
-        if (m_pv->get_name() == m_fieldName) {
-            return m_pv->read_array<TypeValue>();
-        }
-    }
-    throw std::runtime_error("PV " + m_fieldName + " not found");
+    return get_pv(m_fieldName)->read_array<TypeValue>();
+}
+
+template<typename TypeValue>
+std::vector<TypeValue> EpicsProxy::read_pv_array_as(std::string m_fieldName, chtype m_type) {
+    return get_pv(m_fieldName)->read_array_as<TypeValue>(m_type);
+}
+
+template<typename TypeValue>
+std::pmr::vector<TypeValue> EpicsProxy::read_pv_array(std::string m_fieldName, std::pmr::memory_resource* m_resource) {
+    return get_pv(m_fieldName)->read_array<TypeValue>(m_resource);
+}
+
+template<typename TypeValue>
+std::pmr::vector<TypeValue> EpicsProxy::read_pv_array_as(std::string m_fieldName, chtype m_type, std::pmr::memory_resource* m_resource) {
+    return get_pv(m_fieldName)->read_array_as<TypeValue>(m_type, m_resource);
+}
+
+void EpicsProxy::set_wire_type(std::string m_fieldName, chtype m_type) {
+    get_pv(m_fieldName)->set_wire_type(m_type);
+}
+
+void EpicsProxy::set_reduced_precision(std::string m_fieldName, bool enable) {
+    get_pv(m_fieldName)->set_reduced_precision(enable);
+}
+
+void EpicsProxy::set_dynamic_size(std::string m_fieldName, bool enable) {
+    get_pv(m_fieldName)->set_dynamic_size(enable);
+}
+
+std::vector<double> EpicsProxy::read_pv_array_scaled(std::string m_fieldName, double m_scale, double m_offset) {
+    return get_pv(m_fieldName)->read_array_scaled(m_scale, m_offset);
 }
 
 //Instantiate the template function for allowed types
@@ -280,6 +617,30 @@ std::vector<TypeValue> EpicsProxy::read_pv_array(std::string m_fieldName) {
     template std::vector<long> EpicsProxy::read_pv_array<long>(std::string m_fieldName);
     template std::vector<unsigned long> EpicsProxy::read_pv_array<unsigned long>(std::string m_fieldName);
 
+    template std::vector<double> EpicsProxy::read_pv_array_as<double>(std::string m_fieldName, chtype m_type);
+    template std::vector<float> EpicsProxy::read_pv_array_as<float>(std::string m_fieldName, chtype m_type);
+    template std::vector<int> EpicsProxy::read_pv_array_as<int>(std::string m_fieldName, chtype m_type);
+    template std::vector<short> EpicsProxy::read_pv_array_as<short>(std::string m_fieldName, chtype m_type);
+    template std::vector<char> EpicsProxy::read_pv_array_as<char>(std::string m_fieldName, chtype m_type);
+    template std::vector<long> EpicsProxy::read_pv_array_as<long>(std::string m_fieldName, chtype m_type);
+    template std::vector<unsigned long> EpicsProxy::read_pv_array_as<unsigned long>(std::string m_fieldName, chtype m_type);
+
+    template std::pmr::vector<double> EpicsProxy::read_pv_array<double>(std::string m_fieldName, std::pmr::memory_resource* m_resource);
+    template std::pmr::vector<float> EpicsProxy::read_pv_array<float>(std::string m_fieldName, std::pmr::memory_resource* m_resource);
+    template std::pmr::vector<int> EpicsProxy::read_pv_array<int>(std::string m_fieldName, std::pmr::memory_resource* m_resource);
+    template std::pmr::vector<short> EpicsProxy::read_pv_array<short>(std::string m_fieldName, std::pmr::memory_resource* m_resource);
+    template std::pmr::vector<char> EpicsProxy::read_pv_array<char>(std::string m_fieldName, std::pmr::memory_resource* m_resource);
+    template std::pmr::vector<long> EpicsProxy::read_pv_array<long>(std::string m_fieldName, std::pmr::memory_resource* m_resource);
+    template std::pmr::vector<unsigned long> EpicsProxy::read_pv_array<unsigned long>(std::string m_fieldName, std::pmr::memory_resource* m_resource);
+
+    template std::pmr::vector<double> EpicsProxy::read_pv_array_as<double>(std::string m_fieldName, chtype m_type, std::pmr::memory_resource* m_resource);
+    template std::pmr::vector<float> EpicsProxy::read_pv_array_as<float>(std::string m_fieldName, chtype m_type, std::pmr::memory_resource* m_resource);
+    template std::pmr::vector<int> EpicsProxy::read_pv_array_as<int>(std::string m_fieldName, chtype m_type, std::pmr::memory_resource* m_resource);
+    template std::pmr::vector<short> EpicsProxy::read_pv_array_as<short>(std::string m_fieldName, chtype m_type, std::pmr::memory_resource* m_resource);
+    template std::pmr::vector<char> EpicsProxy::read_pv_array_as<char>(std::string m_fieldName, chtype m_type, std::pmr::memory_resource* m_resource);
+    template std::pmr::vector<long> EpicsProxy::read_pv_array_as<long>(std::string m_fieldName, chtype m_type, std::pmr::memory_resource* m_resource);
+    template std::pmr::vector<unsigned long> EpicsProxy::read_pv_array_as<unsigned long>(std::string m_fieldName, chtype m_type, std::pmr::memory_resource* m_resource);
+
     template void EpicsProxy::write_pv<double>(std::string m_fieldName, double m_value);
     template void EpicsProxy::write_pv<float>(std::string m_fieldName, float m_value);
     template void EpicsProxy::write_pv<int>(std::string m_fieldName, int m_value);
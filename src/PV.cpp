@@ -6,6 +6,12 @@
 
 #include "PV.h"
 #include <unistd.h>
+#include <cstring>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <type_traits>
 
 namespace epics {
 
@@ -13,12 +19,78 @@ PV::PV(std::string m_deviceName, std::string m_fieldName){
     fieldName = m_fieldName;
     deviceName = m_deviceName;
     pvName = deviceName + fieldName;
-    _create_channel(false);
+    _ensure_channel(false);
+}
+
+PV::PV(std::string m_deviceName, std::string m_fieldName, unsigned m_priority, bool m_lazy){
+    fieldName = m_fieldName;
+    deviceName = m_deviceName;
+    pvName = deviceName + fieldName;
+    priority = m_priority;
+    lazy = m_lazy;
+    if (!lazy) {
+        _ensure_channel(false);
+    }
 }
 
 PV::~PV(){
         remove_monitor();
+        //Other PVs may keep the channel open, so releasing it does not cancel a put in
+        //flight; the writer goes once its callback has come
+        _retire_coalescer();
         clear_channel();
+        delete chunker;
+}
+
+void PV::set_write_buffer(caWriteBuffer* m_writeBuffer) {
+    writeBuffer = m_writeBuffer;
+    if (coalescer != nullptr) {
+        coalescer->set_write_buffer(writeBuffer);
+    }
+}
+
+//The writer is swapped under the channel lock, which connection handlers hold while
+//they call connection_state
+void PV::set_coalescing(bool enable) {
+    if (enable) {
+        _ensure_channel(true);
+    }
+    if (enable && coalescer == nullptr) {
+        caCoalescingWriter* m_writer = new caCoalescingWriter(channel, pvName, &latency, &counters);
+        m_writer->set_write_buffer(writeBuffer);
+        std::lock_guard<std::mutex> lock(shared->mutex);
+        coalescer = m_writer;
+    } else if (!enable && coalescer != nullptr) {
+        //A value not yet sent is discarded
+        _retire_coalescer();
+    }
+}
+
+//Give a put in flight up to 5 s to complete before the writer goes. A writer whose put is
+//still outstanding is left with the channel, which frees it once cleared.
+void PV::_retire_coalescer() {
+    caCoalescingWriter* m_writer = coalescer;
+    if (shared != nullptr) {
+        std::lock_guard<std::mutex> lock(shared->mutex);
+        coalescer = nullptr;
+    } else {
+        coalescer = nullptr;
+    }
+    if (!caCoalescingWriter::retire(m_writer, 5.0)) {
+        caChannelTable::instance().keep_until_cleared(shared, std::shared_ptr<caCoalescingWriter>(m_writer));
+    }
+}
+
+void PV::set_chunking(bool enable, chunkConfig m_config) {
+    delete chunker;
+    chunker = enable ? new caChunkedArray(pvName, priority, m_config, &counters) : nullptr;
+}
+
+coalescingCounters PV::get_coalescing_counters() {
+    if (coalescer == nullptr) {
+        return coalescingCounters();
+    }
+    return coalescer->get_counters();
 }
 
 void PV::clear_channel(){
@@ -26,106 +98,443 @@ void PV::clear_channel(){
 }
 
 chtype PV::get_field_type(){
-    return ca_field_type(channel);
+    _ensure_channel(true);
+    return get_transport()->field_type(channel);
 }
 
 template<typename TypeValue>
 void PV::write(TypeValue newValue) {
+    _ensure_channel(true);
     _put(newValue);
 }
 
 void PV::write_string(std::string newValue) {
+    _ensure_channel(true);
     _put_string(newValue);
 }
 
 template<typename TypeValue>
 void PV::write_array(std::vector<TypeValue> newValue) {
+    _ensure_channel(true);
     _put_array(newValue);
 }
 
 template<typename TypeValue>
 TypeValue PV::read() {
+    _ensure_channel(true);
     TypeValue value = _get<TypeValue>();
     return value;
 }
 
 std::string PV::read_string() {
+    _ensure_channel(true);
     std::string value = _get_string();
     return value;
 }
 
 template<typename TypeValue>
 std::vector<TypeValue> PV::read_array() {
-    std::vector<TypeValue> value = _get_array<TypeValue>();
+    _ensure_channel(true);
+    std::vector<TypeValue> value = _get_array<TypeValue>(_wire_type());
+    return value;
+}
+
+template<typename TypeValue>
+std::vector<TypeValue> PV::read_array_as(chtype m_type) {
+    _ensure_channel(true);
+    std::vector<TypeValue> value = _get_array<TypeValue>(m_type);
     return value;
 }
 
+template<typename TypeValue>
+std::pmr::vector<TypeValue> PV::read_array(std::pmr::memory_resource* m_resource) {
+    _ensure_channel(true);
+    return _get_array<TypeValue>(_wire_type(), std::pmr::polymorphic_allocator<TypeValue>(m_resource));
+}
+
+template<typename TypeValue>
+std::pmr::vector<TypeValue> PV::read_array_as(chtype m_type, std::pmr::memory_resource* m_resource) {
+    _ensure_channel(true);
+    return _get_array<TypeValue>(m_type, std::pmr::polymorphic_allocator<TypeValue>(m_resource));
+}
+
+void PV::set_wire_type(chtype m_type) {
+    if (m_type != TYPENOTCONN && (m_type < DBR_STRING || m_type > DBR_DOUBLE)) {
+        throw std::runtime_error("Invalid CA request type: " + std::to_string(m_type));
+    }
+    wireType = m_type;
+}
+
+void PV::set_reduced_precision(bool enable) {
+    chtype native = get_field_type();
+    if (!enable) {
+        wireType = TYPENOTCONN;
+    } else if (native == DBR_DOUBLE) {
+        wireType = DBR_FLOAT;
+    } else if (native == DBR_LONG) {
+        wireType = DBR_SHORT;
+    }
+}
+
+chtype PV::_wire_type() {
+    return wireType != TYPENOTCONN ? wireType : get_transport()->field_type(channel);
+}
+
+template<typename Wire, typename TypeValue>
+static void widen(const void* m_wire, TypeValue* m_out, unsigned long m_count) {
+    const Wire* m_in = static_cast<const Wire*>(m_wire);
+    for (unsigned long i = 0; i < m_count; i++) {
+        m_out[i] = static_cast<TypeValue>(m_in[i]);
+    }
+}
+
+//Convert count values of a requested DBR type to TypeValue
+template<typename TypeValue>
+static void convert_wire(const void* m_wire, chtype m_type, TypeValue* m_out, unsigned long m_count) {
+    if constexpr (std::is_same_v<TypeValue, double>) {
+        caConvert::to_double(m_wire, m_type, m_out, m_count);
+    } else if (m_type == DBR_DOUBLE) {
+        widen<dbr_double_t>(m_wire, m_out, m_count);
+    } else if (m_type == DBR_FLOAT) {
+        widen<dbr_float_t>(m_wire, m_out, m_count);
+    } else if (m_type == DBR_LONG) {
+        widen<dbr_long_t>(m_wire, m_out, m_count);
+    } else if (m_type == DBR_SHORT) {
+        widen<dbr_short_t>(m_wire, m_out, m_count);
+    } else if (m_type == DBR_ENUM) {
+        widen<dbr_enum_t>(m_wire, m_out, m_count);
+    } else if (m_type == DBR_CHAR) {
+        widen<dbr_char_t>(m_wire, m_out, m_count);
+    } else {
+        throw std::runtime_error("Invalid CA request type: " + std::to_string(m_type));
+    }
+}
+
+std::vector<double> PV::read_array_scaled(double m_scale, double m_offset) {
+    _ensure_channel(true);
+    return _get_array_scaled(_wire_type(), m_scale, m_offset);
+}
+
+std::vector<double> PV::_get_array_scaled(chtype m_type, double m_scale, double m_offset) {
+    caTraceSpan span("get_array", pvName.c_str());
+    if (dynamicSize) {
+        std::vector<char> wire;
+        int status;
+        uint64_t start = caLatencyStats::now();
+        unsigned long valid = _get_dynamic(m_type, wire, status);
+        span.set_status(status);
+        latency.record(LATENCY_GET, start);
+        std::vector<double> pval(valid);
+        caConvert::to_double(wire.data(), m_type, pval.data(), valid, m_scale, m_offset);
+        return pval;
+    }
+    unsigned long element_count = get_transport()->element_count(channel);
+    std::vector<char> wire(dbr_size_n(m_type, element_count));
+    uint64_t start = caLatencyStats::now();
+    span.set_status(_fetch_array(m_type, element_count, wire.data()));
+    latency.record(LATENCY_GET, start);
+    counters.gets.add();
+    counters.bytesReceived.add(wire.size());
+    std::vector<double> pval(element_count);
+    caConvert::to_double(wire.data(), m_type, pval.data(), element_count, m_scale, m_offset);
+    return pval;
+}
+
 template<typename TypeValue>
 TypeValue PV::_get() {
+    caTraceSpan span("get", pvName.c_str());
     TypeValue pval;
-    SEVCHK(ca_get(ca_field_type(channel), channel, &pval), ("Failed to get value from PV " + pvName).c_str());
-    SEVCHK(ca_pend_io(5.0), ("Failed to get value from PV " + pvName).c_str())
+    uint64_t start = caLatencyStats::now();
+    chtype field_type = get_transport()->field_type(channel);
+    int status = get_transport()->array_get(field_type, 1, channel, &pval);
+    span.set_status(status);
+    SEVCHK(status, ("Failed to get value from PV " + pvName).c_str());
+    span.set_status(_pend_io("Failed to get value from PV "));
+    latency.record(LATENCY_GET, start);
+    counters.gets.add();
+    counters.bytesReceived.add(dbr_size_n(field_type, 1));
     return pval;
 }
 
 std::string PV::_get_string() {
+    caTraceSpan span("get", pvName.c_str());
     dbr_string_t pValue;
-    SEVCHK(ca_get(DBR_STRING, channel, &pValue), ("Failed to get value from PV " + pvName).c_str());
-    SEVCHK(ca_pend_io(5.0), ("Failed to get value from PV " + pvName).c_str())
+    uint64_t start = caLatencyStats::now();
+    int status = get_transport()->array_get(DBR_STRING, 1, channel, &pValue);
+    span.set_status(status);
+    SEVCHK(status, ("Failed to get value from PV " + pvName).c_str());
+    span.set_status(_pend_io("Failed to get value from PV "));
+    latency.record(LATENCY_GET, start);
+    counters.gets.add();
+    counters.bytesReceived.add(dbr_size_n(DBR_STRING, 1));
     return std::string(static_cast<const char*>(pValue));
 }
 
-template<typename TypeValue>
-std::vector<TypeValue> PV::_get_array() {
-    long element_count = ca_element_count(channel);
-    chtype field_type = ca_field_type(channel);
-    TypeValue* array = new TypeValue[element_count];
-    std::vector<TypeValue> pval;
-    SEVCHK(ca_array_get(field_type, element_count, channel, array), ("Failed to get value from PV " + pvName).c_str());
-    SEVCHK(ca_pend_io(5.0), ("Failed to get value from PV " + pvName).c_str())
+//The plain DBR type whose elements are laid out exactly as TypeValue, or TYPENOTCONN when
+//there is none (long and unsigned long are wider than DBR_LONG). Like the rest of the
+//library, DBR_CHAR is read into char.
+template<typename TypeValue> struct nativeDbr {static constexpr chtype type = TYPENOTCONN;};
+template<> struct nativeDbr<dbr_double_t> {static constexpr chtype type = DBR_DOUBLE;};
+template<> struct nativeDbr<dbr_float_t> {static constexpr chtype type = DBR_FLOAT;};
+template<> struct nativeDbr<dbr_long_t> {static constexpr chtype type = DBR_LONG;};
+template<> struct nativeDbr<dbr_short_t> {static constexpr chtype type = DBR_SHORT;};
+template<> struct nativeDbr<dbr_enum_t> {static constexpr chtype type = DBR_ENUM;};
+template<> struct nativeDbr<dbr_char_t> {static constexpr chtype type = DBR_CHAR;};
+template<> struct nativeDbr<char> {static constexpr chtype type = DBR_CHAR;};
+
+//A requested type stored like TypeValue is read straight into the result. Any other
+//requested type is converted by the IOC and widened here. Buffers come from m_alloc, so a pmr
+//allocator keeps the whole read (except dynamic size replies) in the caller's resource.
+template<typename TypeValue, typename Alloc>
+std::vector<TypeValue, Alloc> PV::_get_array(chtype m_type, const Alloc& m_alloc) {
+    typedef typename std::allocator_traits<Alloc>::template rebind_alloc<char> charAlloc;
+    caTraceSpan span("get_array", pvName.c_str());
+    std::vector<TypeValue, Alloc> pval(m_alloc);
+    if (dynamicSize) {
+        std::vector<char> wire;
+        int status;
+        uint64_t start = caLatencyStats::now();
+        unsigned long valid = _get_dynamic(m_type, wire, status);
+        span.set_status(status);
+        latency.record(LATENCY_GET, start);
+        pval.resize(valid);
+        convert_wire(wire.data(), m_type, pval.data(), valid);
+        return pval;
+    }
+    long element_count = get_transport()->element_count(channel);
     std::size_t size = static_cast<std::size_t>(element_count);
-    pval.resize(size);
-    std::copy(array, array + size, pval.begin());
-    delete[] array;
+    uint64_t start = caLatencyStats::now();
+    if (nativeDbr<TypeValue>::type != TYPENOTCONN && m_type == nativeDbr<TypeValue>::type) {
+        pval.resize(size);
+        span.set_status(_fetch_array(m_type, element_count, pval.data()));
+    } else {
+        std::vector<char, charAlloc> wire(dbr_size_n(m_type, element_count), charAlloc(m_alloc));
+        span.set_status(_fetch_array(m_type, element_count, wire.data()));
+        pval.resize(size);
+        convert_wire(wire.data(), m_type, pval.data(), element_count);
+    }
+    latency.record(LATENCY_GET, start);
+    counters.gets.add();
+    counters.bytesReceived.add(dbr_size_n(m_type, element_count));
     return pval;
 }
 
 template<typename TypeValue>
 void PV::_put(TypeValue value) {
+        caTraceSpan span("put", pvName.c_str());
         chtype field_type = get_dbr_type(typeid(value).name());
-        SEVCHK(ca_put(field_type, channel, &value), ("Failed to put value to PV " + pvName).c_str());
-        SEVCHK(ca_pend_io(5.0), ("Failed to get value from PV " + pvName).c_str())
+        if (coalescer != nullptr) {
+            coalescer->write(field_type, 1, &value);
+            return;
+        }
+        uint64_t start = caLatencyStats::now();
+        int status = get_transport()->array_put(field_type, 1, channel, &value);
+        span.set_status(status);
+        SEVCHK(status, ("Failed to put value to PV " + pvName).c_str());
+        span.set_status(_complete_put(field_type, 1, start));
 }
 
 void PV::_put_string(std::string value){
-        SEVCHK(ca_put(DBR_STRING, channel, value.c_str()), ("Failed to put value to PV " + std::string(pvName)).c_str());
-        SEVCHK(ca_pend_io(5.0), ("Failed to get value from PV " + pvName).c_str())
+        caTraceSpan span("put", pvName.c_str());
+        if (coalescer != nullptr) {
+            dbr_string_t buffer = {};
+            std::strncpy(buffer, value.c_str(), sizeof(buffer) - 1);
+            coalescer->write(DBR_STRING, 1, buffer);
+            return;
+        }
+        uint64_t start = caLatencyStats::now();
+        int status = get_transport()->array_put(DBR_STRING, 1, channel, value.c_str());
+        span.set_status(status);
+        SEVCHK(status, ("Failed to put value to PV " + std::string(pvName)).c_str());
+        span.set_status(_complete_put(DBR_STRING, 1, start));
 }
 
 template<typename TypeValue>
 void PV::_put_array(std::vector<TypeValue> value) {
+        caTraceSpan span("put_array", pvName.c_str());
         TypeValue* array = new TypeValue[value.size()];
         std::size_t num_elements = value.size();
         unsigned long count = static_cast<unsigned long>(num_elements);
         TypeValue first_element = value[0];
         chtype field_type = get_dbr_type(typeid(first_element).name());
         std::copy(value.begin(), value.end(), array);
-        SEVCHK(ca_array_put(field_type, count, channel, array), ("Failed to put value to PV " + pvName).c_str());
-        SEVCHK(ca_pend_io(5.0), ("Failed to get value from PV " + pvName).c_str())
+        if (coalescer != nullptr) {
+            coalescer->write(field_type, count, array);
+            delete[] array;
+            return;
+        }
+        uint64_t start = caLatencyStats::now();
+        if (chunker != nullptr && chunker->can_write() && chunker->needs_pieces(field_type, count)) {
+            chunker->write(field_type, count, array);
+            delete[] array;
+            counters.puts.add();
+            counters.bytesSent.add(dbr_size_n(field_type, count));
+            latency.record(LATENCY_PUT, start);
+            return;
+        }
+        int status = get_transport()->array_put(field_type, count, channel, array);
+        span.set_status(status);
+        SEVCHK(status, ("Failed to put value to PV " + pvName).c_str());
+        span.set_status(_complete_put(field_type, count, start));
         delete[] array;
 }
 
+// Puts without a callback need no reply. In buffered mode the request stays in the
+// CA send queue and the write buffer decides when to flush; otherwise wait as before.
+// Only unbuffered puts are timed, since a buffered put has not been sent yet.
+// Returns the pend_io status, or ECA_NORMAL for a queued put.
+int PV::_complete_put(chtype field_type, unsigned long count, uint64_t start) {
+    counters.puts.add();
+    counters.bytesSent.add(dbr_size_n(field_type, count));
+    if (writeBuffer != nullptr) {
+        writeBuffer->queued(dbr_size_n(field_type, count));
+        return ECA_NORMAL;
+    }
+    int status = _pend_io("Failed to put value to PV ");
+    latency.record(LATENCY_PUT, start);
+    return status;
+}
+
+//The channel comes from the process-wide table, so PVs with the same name share one chid.
+//It has a connection handler so connects can be timed. ca_pend_io does not wait for such
+//channels, so callers wait with wait_connected instead.
 void PV::_create_channel(bool pend){
-    SEVCHK(ca_create_channel(pvName.c_str(), NULL, NULL, 20, &channel), ("Failed to create channel for PV " + pvName).c_str());
-    if (pend) {
-        SEVCHK(ca_pend_io(5.0), ("Failed to create channel for PV " + pvName).c_str());
+    createdAt = caLatencyStats::now();
+    shared = caChannelTable::instance().acquire(pvName, priority, channelUser{connection_state, this});
+    channel = shared->channel;
+    if (pend && !wait_connected(5.0)) {
+        counters.timeouts.add();
+        SEVCHK(ECA_TIMEOUT, ("Failed to create channel for PV " + pvName).c_str());
+    }
+}
+
+//Creates the channel once, from whichever thread gets there first. A lazy PV that has
+//never connected waits for the connection when the caller needs it.
+void PV::_ensure_channel(bool m_wait) {
+    std::call_once(channelOnce, [this]() {
+        _create_channel(false);
+        channelCreated = true;
+    });
+    if (m_wait && lazy && !everConnected && !wait_connected(5.0)) {
+        counters.timeouts.add();
+        SEVCHK(ECA_TIMEOUT, ("Failed to connect channel for PV " + pvName).c_str());
+    }
+}
+
+void PV::connection_state(void* usr, bool m_connected) {
+    PV* m_pv = static_cast<PV*>(usr);
+    if (m_connected) {
+        if (!m_pv->everConnected.exchange(true)) {
+            m_pv->latency.record(LATENCY_CONNECT, m_pv->createdAt);
+        }
+        m_pv->connected = true;
+        if (m_pv->coalescer != nullptr) {
+            m_pv->coalescer->resend();
+        }
+    } else {
+        if (m_pv->connected.exchange(false)) {
+            m_pv->counters.disconnects.add();
+        }
+    }
+}
+
+bool PV::wait_connected(double timeout) {
+    if (connected) {
+        return true;
+    }
+    SEVCHK(get_transport()->flush_io(), ("Failed to create channel for PV " + pvName).c_str());
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::duration<double>(timeout);
+    while (!connected && std::chrono::steady_clock::now() < deadline) {
+        get_transport()->pend_event(0.001);
+    }
+    return connected;
+}
+
+//pend_io that counts timeouts before reporting them; returns the status for trace spans
+int PV::_pend_io(std::string m_message) {
+    int status = get_transport()->pend_io(5.0);
+    if (status == ECA_TIMEOUT) {
+        counters.timeouts.add();
+    }
+    SEVCHK(status, (m_message + pvName).c_str());
+    return status;
+}
+
+//Read m_count elements of m_type into m_dest, in pieces when the array is too large for one
+//message. Returns the first failing status, or ECA_NORMAL.
+int PV::_fetch_array(chtype m_type, unsigned long m_count, void* m_dest) {
+    if (chunker != nullptr && chunker->needs_pieces(m_type, m_count)) {
+        chunker->read(m_type, m_count, m_dest);
+        return ECA_NORMAL;
+    }
+    int status = get_transport()->array_get(m_type, m_count, channel, m_dest);
+    SEVCHK(status, ("Failed to get value from PV " + pvName).c_str());
+    int pend = _pend_io("Failed to get value from PV ");
+    return status != ECA_NORMAL ? status : pend;
+}
+
+//Reply of a dynamic size get. The callback owns one reference, so a reply that arrives
+//after the caller gave up still has somewhere to go.
+struct dynamicGet {
+    std::mutex mutex;
+    std::condition_variable replied;
+    bool done = false;
+    int status = ECA_NORMAL;
+    unsigned long count = 0;
+    std::vector<char> wire;
+};
+
+static void dynamic_callback(struct event_handler_args args) {
+    std::unique_ptr<std::shared_ptr<dynamicGet>> holder(static_cast<std::shared_ptr<dynamicGet>*>(args.usr));
+    dynamicGet& get = **holder;
+    std::lock_guard<std::mutex> lock(get.mutex);
+    get.status = args.status;
+    if (args.status == ECA_NORMAL && args.dbr != nullptr) {
+        const char* data = static_cast<const char*>(args.dbr);
+        get.count = static_cast<unsigned long>(args.count);
+        //Not dbr_size_n, which counts one element for an empty reply
+        get.wire.assign(data, data + args.count * dbr_value_size[args.type]);
+    }
+    get.done = true;
+    get.replied.notify_all();
+}
+
+//Get with count 0, which makes the IOC send only the valid elements. ca_pend_io does not
+//wait for callback gets; the callback runs on a CA thread (the context is preemptive)
+//and wakes the caller as soon as the reply is in.
+//m_status is set to the request's or the reply's status.
+unsigned long PV::_get_dynamic(chtype m_type, std::vector<char>& m_wire, int& m_status) {
+    auto get = std::make_shared<dynamicGet>();
+    auto holder = new std::shared_ptr<dynamicGet>(get);
+    m_status = get_transport()->array_get_callback(m_type, 0, channel, dynamic_callback, holder);
+    if (m_status != ECA_NORMAL) {
+        delete holder;
+        SEVCHK(m_status, ("Failed to get value from PV " + pvName).c_str());
+        return 0;
+    }
+    SEVCHK(get_transport()->flush_io(), ("Failed to get value from PV " + pvName).c_str());
+    std::unique_lock<std::mutex> lock(get->mutex);
+    if (!get->replied.wait_for(lock, std::chrono::seconds(5), [&get]() {return get->done;})) {
+        counters.timeouts.add();
+        m_status = ECA_TIMEOUT;
+        SEVCHK(ECA_TIMEOUT, ("Failed to get value from PV " + pvName).c_str());
+        return 0;
     }
-    //ca_set_puser(channel, puser);
+    m_status = get->status;
+    SEVCHK(get->status, ("Failed to get value from PV " + pvName).c_str());
+    counters.gets.add();
+    counters.bytesReceived.add(get->wire.size());
+    m_wire = std::move(get->wire);
+    return get->count;
 }
 
 void PV::_clear_channel(){
-    SEVCHK(ca_pend_io(5.0), ("Failed to get value from PV " + pvName).c_str());
-    SEVCHK(ca_clear_channel(channel), ("Failed to destroy channel for PV " + pvName).c_str());
+    if (!channelCreated) {
+        return;
+    }
+    _pend_io("Failed to get value from PV ");
+    caChannelTable::instance().release(shared, this);
+    shared = nullptr;
 }
 
 //Instantiate the template function for allowed types
@@ -145,6 +554,30 @@ template std::vector<char> PV::read_array<char>();
 template std::vector<long> PV::read_array<long>();
 template std::vector<unsigned long> PV::read_array<unsigned long>();
 
+template std::vector<double> PV::read_array_as<double>(chtype m_type);
+template std::vector<float> PV::read_array_as<float>(chtype m_type);
+template std::vector<int> PV::read_array_as<int>(chtype m_type);
+template std::vector<short> PV::read_array_as<short>(chtype m_type);
+template std::vector<char> PV::read_array_as<char>(chtype m_type);
+template std::vector<long> PV::read_array_as<long>(chtype m_type);
+template std::vector<unsigned long> PV::read_array_as<unsigned long>(chtype m_type);
+
+template std::pmr::vector<double> PV::read_array<double>(std::pmr::memory_resource* m_resource);
+template std::pmr::vector<float> PV::read_array<float>(std::pmr::memory_resource* m_resource);
+template std::pmr::vector<int> PV::read_array<int>(std::pmr::memory_resource* m_resource);
+template std::pmr::vector<short> PV::read_array<short>(std::pmr::memory_resource* m_resource);
+template std::pmr::vector<char> PV::read_array<char>(std::pmr::memory_resource* m_resource);
+template std::pmr::vector<long> PV::read_array<long>(std::pmr::memory_resource* m_resource);
+template std::pmr::vector<unsigned long> PV::read_array<unsigned long>(std::pmr::memory_resource* m_resource);
+
+template std::pmr::vector<double> PV::read_array_as<double>(chtype m_type, std::pmr::memory_resource* m_resource);
+template std::pmr::vector<float> PV::read_array_as<float>(chtype m_type, std::pmr::memory_resource* m_resource);
+template std::pmr::vector<int> PV::read_array_as<int>(chtype m_type, std::pmr::memory_resource* m_resource);
+template std::pmr::vector<short> PV::read_array_as<short>(chtype m_type, std::pmr::memory_resource* m_resource);
+template std::pmr::vector<char> PV::read_array_as<char>(chtype m_type, std::pmr::memory_resource* m_resource);
+template std::pmr::vector<long> PV::read_array_as<long>(chtype m_type, std::pmr::memory_resource* m_resource);
+template std::pmr::vector<unsigned long> PV::read_array_as<unsigned long>(chtype m_type, std::pmr::memory_resource* m_resource);
+
 template void PV::write<double>(double newValue);
 template void PV::write<float>(float newValue);
 template void PV::write<int>(int newValue);
@@ -188,17 +621,111 @@ chtype PV::get_dbr_type(std::string type_name) {
 
 // Add a monitor for the PV and add the event id to the list of monitors
 void PV::add_monitor(EpicsProxy* proxy, void (*callback)(struct event_handler_args args)) {
-    evid monitor;
-    SEVCHK(ca_add_masked_array_event(ca_field_type(channel), 1, channel, callback, proxy, 0.0, 0.0, 0.0, &monitor, DBE_VALUE), ("Failed to add monitor for PV " + pvName).c_str());
-    SEVCHK(ca_pend_io(5.0), ("Failed to add monitor for PV " + pvName).c_str());
-    monitors.push_back(monitor);
+    _ensure_channel(true);
+    //Owned here until the table has taken the subscription, which may throw
+    auto hook = std::make_unique<monitorHook>();
+    hook->pv = this;
+    hook->callback = callback;
+    hook->usr = proxy;
+    hook->subscription = caChannelTable::instance().subscribe(shared, _wire_type(), dynamicSize ? 0 : 1, DBE_VALUE, monitor_callback, hook.get());
+    monitors.push_back(hook.release());
+    _pend_io("Failed to add monitor for PV ");
+}
+
+void PV::monitor_callback(struct event_handler_args args) {
+    monitorHook* hook = static_cast<monitorHook*>(args.usr);
+    uint64_t now = caLatencyStats::now();
+    uint64_t last = hook->lastEvent.exchange(now, std::memory_order_relaxed);
+    if (last != 0) {
+        hook->pv->latency.record_duration(LATENCY_MONITOR_INTERVAL, now - last);
+    }
+    hook->pv->counters.monitorEvents.add();
+    hook->pv->counters.bytesReceived.add(args.count * dbr_value_size[args.type]);
+    caTraceSpan span("monitor", hook->pv->pvName.c_str());
+    span.set_status(args.status);
+    args.usr = hook->usr;
+    hook->callback(args);
+}
+
+caTripleBuffer* PV::add_array_monitor() {
+    _ensure_channel(true);
+    unsigned long element_count = get_transport()->element_count(channel);
+    auto hook = std::make_unique<frameHook>();
+    auto frames = std::make_unique<caTripleBuffer>(_wire_type(), element_count);
+    hook->pv = this;
+    hook->frames = frames.get();
+    hook->subscription = caChannelTable::instance().subscribe(shared, frames->get_type(), dynamicSize ? 0 : element_count,
+                                                              DBE_VALUE, frame_callback, hook.get());
+    frames.release();
+    frameMonitors.push_back(hook.release());
+    _pend_io("Failed to add monitor for PV ");
+    return frameMonitors.back()->frames;
+}
+
+//The one copy out of the CA receive buffer, into the writer's free frame
+void PV::frame_callback(struct event_handler_args args) {
+    frameHook* hook = static_cast<frameHook*>(args.usr);
+    if (args.status != ECA_NORMAL || args.dbr == nullptr) {
+        return;
+    }
+    hook->pv->counters.monitorEvents.add();
+    //Not dbr_size_n, which counts one element for an empty dynamic-size event
+    hook->pv->counters.bytesReceived.add(args.count * dbr_value_size[args.type]);
+    caTraceSpan span("monitor", hook->pv->pvName.c_str());
+    hook->frames->publish(args.dbr, static_cast<unsigned long>(args.count));
+}
+
+caReduction* PV::add_reduction(reductionCallback* m_callback, void* m_usr) {
+    _ensure_channel(true);
+    chtype type = _wire_type();
+    if (type == DBR_STRING) {
+        throw std::runtime_error("PV " + pvName + " holds strings, which cannot be reduced");
+    }
+    unsigned long element_count = get_transport()->element_count(channel);
+    auto hook = std::make_unique<reductionHook>();
+    auto reduction = std::make_unique<caReduction>(m_callback, m_usr);
+    hook->pv = this;
+    hook->reduction = reduction.get();
+    hook->subscription = caChannelTable::instance().subscribe(shared, type, dynamicSize ? 0 : element_count,
+                                                              DBE_VALUE, reduction_callback, hook.get());
+    reduction.release();
+    reductionMonitors.push_back(hook.release());
+    _pend_io("Failed to add monitor for PV ");
+    return reductionMonitors.back()->reduction;
+}
+
+//Reduced straight from the CA event buffer
+void PV::reduction_callback(struct event_handler_args args) {
+    reductionHook* hook = static_cast<reductionHook*>(args.usr);
+    if (args.status != ECA_NORMAL || args.dbr == nullptr) {
+        return;
+    }
+    hook->pv->counters.monitorEvents.add();
+    hook->pv->counters.bytesReceived.add(args.count * dbr_value_size[args.type]);
+    caTraceSpan span("monitor", hook->pv->pvName.c_str());
+    hook->reduction->process(args.dbr, args.type, static_cast<unsigned long>(args.count));
 }
 
 void PV::remove_monitor() {
-    for (auto monitor : monitors) {
-        SEVCHK(ca_clear_event(monitor), ("Failed to remove monitor for PV " + pvName).c_str());
-        SEVCHK(ca_pend_io(5.0), ("Failed to remove monitor for PV " + pvName).c_str());
+    for (monitorHook* hook : monitors) {
+        caChannelTable::instance().unsubscribe(hook->subscription, hook);
+        _pend_io("Failed to remove monitor for PV ");
+        delete hook;
     }
     monitors.clear();
+    for (frameHook* hook : frameMonitors) {
+        caChannelTable::instance().unsubscribe(hook->subscription, hook);
+        _pend_io("Failed to remove monitor for PV ");
+        delete hook->frames;
+        delete hook;
+    }
+    frameMonitors.clear();
+    for (reductionHook* hook : reductionMonitors) {
+        caChannelTable::instance().unsubscribe(hook->subscription, hook);
+        _pend_io("Failed to remove monitor for PV ");
+        delete hook->reduction;
+        delete hook;
+    }
+    reductionMonitors.clear();
 }
 }
\ No newline at end of file
@@ -0,0 +1,223 @@
+/**
+ * @file TypedPV.cpp
+ * @brief Implementation of the statically typed PV handle.
+ */
+
+#include "TypedPV.h"
+#include "caSnapshot.h"
+
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+namespace epics {
+
+//True when every value of From is represented exactly by To. Single bytes are taken as
+//the same, as DBR_CHAR is read into char throughout this library.
+template<typename From, typename To>
+static constexpr bool lossless() {
+    if constexpr (std::is_same_v<From, To>) {
+        return true;
+    } else if constexpr (!std::is_arithmetic_v<To> || !std::is_arithmetic_v<From>) {
+        return false;
+    } else if constexpr (std::is_integral_v<From> && std::is_integral_v<To> && sizeof(From) == 1 && sizeof(To) == 1) {
+        return true;
+    } else if constexpr (std::is_floating_point_v<To>) {
+        return std::numeric_limits<From>::digits <= std::numeric_limits<To>::digits;
+    } else if constexpr (std::is_integral_v<From>) {
+        return std::numeric_limits<From>::digits <= std::numeric_limits<To>::digits
+            && (std::is_signed_v<To> || !std::is_signed_v<From>);
+    } else {
+        return false;
+    }
+}
+
+template<typename From, typename To>
+static void convert_values(const void* m_wire, To* m_out, unsigned long m_count) {
+    const From* m_in = static_cast<const From*>(m_wire);
+    if constexpr (std::is_same_v<To, double>) {
+        caConvert::to_double(m_in, m_out, m_count);
+    } else {
+        for (unsigned long i = 0; i < m_count; i++) {
+            m_out[i] = static_cast<To>(m_in[i]);
+        }
+    }
+}
+
+static void convert_strings(const void* m_wire, std::string* m_out, unsigned long m_count) {
+    const dbr_string_t* m_in = static_cast<const dbr_string_t*>(m_wire);
+    for (unsigned long i = 0; i < m_count; i++) {
+        m_out[i] = std::string(m_in[i], strnlen(m_in[i], sizeof(dbr_string_t)));
+    }
+}
+
+//The conversion for reading native type From into To, or nullptr if it would lose data
+template<typename From, typename To>
+static typename TypedPV<To>::convertFunc select_conversion() {
+    if constexpr (lossless<From, To>()) {
+        return &convert_values<From, To>;
+    } else {
+        return nullptr;
+    }
+}
+
+template<typename TypeValue>
+TypedPV<TypeValue>::TypedPV(PV* m_pv) {
+    pv = m_pv;
+    pv->_ensure_channel(true);
+    if (!pv->wait_connected(5.0)) {
+        throw std::runtime_error("PV " + pv->pvName + " is not connected");
+    }
+    chtype native = get_transport()->field_type(pv->channel);
+    elementCount = get_transport()->element_count(pv->channel);
+    //DBR_TIME_x - DBR_TIME_STRING is DBR_x
+    writeType = snapshotType<TypeValue>::type - DBR_TIME_STRING;
+    if constexpr (std::is_same_v<TypeValue, std::string>) {
+        readType = DBR_STRING;
+        convert = &convert_strings;
+        return;
+    } else {
+        readType = native;
+        switch (native) {
+            case DBR_DOUBLE: convert = select_conversion<dbr_double_t, TypeValue>(); break;
+            case DBR_FLOAT: convert = select_conversion<dbr_float_t, TypeValue>(); break;
+            case DBR_LONG: convert = select_conversion<dbr_long_t, TypeValue>(); break;
+            case DBR_SHORT: convert = select_conversion<dbr_short_t, TypeValue>(); break;
+            case DBR_ENUM: convert = select_conversion<dbr_enum_t, TypeValue>(); break;
+            case DBR_CHAR: convert = select_conversion<dbr_char_t, TypeValue>(); break;
+            default: convert = nullptr;
+        }
+        if (convert == nullptr) {
+            throw std::runtime_error("PV " + pv->pvName + " has native type " + std::to_string(native)
+                                     + ", which the handle's value type cannot hold exactly");
+        }
+    }
+}
+
+template<typename TypeValue>
+TypedPV<TypeValue>::~TypedPV() {
+    remove_monitors();
+}
+
+template<typename TypeValue>
+TypeValue TypedPV<TypeValue>::read() {
+    caTraceSpan span("get", pv->pvName.c_str());
+    alignas(dbr_double_t) char wire[sizeof(dbr_string_t)];
+    uint64_t start = caLatencyStats::now();
+    int status = get_transport()->array_get(readType, 1, pv->channel, wire);
+    span.set_status(status);
+    SEVCHK(status, ("Failed to get value from PV " + pv->pvName).c_str());
+    span.set_status(pv->_pend_io("Failed to get value from PV "));
+    pv->latency.record(LATENCY_GET, start);
+    pv->counters.gets.add();
+    pv->counters.bytesReceived.add(dbr_size_n(readType, 1));
+    TypeValue value;
+    convert(wire, &value, 1);
+    return value;
+}
+
+template<typename TypeValue>
+std::vector<TypeValue> TypedPV<TypeValue>::read_array() {
+    caTraceSpan span("get_array", pv->pvName.c_str());
+    std::vector<char> wire(dbr_size_n(readType, elementCount));
+    uint64_t start = caLatencyStats::now();
+    int status = get_transport()->array_get(readType, elementCount, pv->channel, wire.data());
+    span.set_status(status);
+    SEVCHK(status, ("Failed to get value from PV " + pv->pvName).c_str());
+    span.set_status(pv->_pend_io("Failed to get value from PV "));
+    pv->latency.record(LATENCY_GET, start);
+    pv->counters.gets.add();
+    pv->counters.bytesReceived.add(wire.size());
+    std::vector<TypeValue> values(elementCount);
+    convert(wire.data(), values.data(), elementCount);
+    return values;
+}
+
+template<typename TypeValue>
+void TypedPV<TypeValue>::write(const TypeValue& m_value) {
+    caTraceSpan span("put", pv->pvName.c_str());
+    typename snapshotType<TypeValue>::wire wire;
+    if constexpr (std::is_same_v<TypeValue, std::string>) {
+        std::memset(wire, 0, sizeof(wire));
+        std::strncpy(wire, m_value.c_str(), sizeof(wire) - 1);
+    } else {
+        wire = static_cast<typename snapshotType<TypeValue>::wire>(m_value);
+    }
+    if (pv->coalescer != nullptr) {
+        pv->coalescer->write(writeType, 1, &wire);
+        return;
+    }
+    uint64_t start = caLatencyStats::now();
+    int status = get_transport()->array_put(writeType, 1, pv->channel, &wire);
+    span.set_status(status);
+    SEVCHK(status, ("Failed to put value to PV " + pv->pvName).c_str());
+    span.set_status(pv->_complete_put(writeType, 1, start));
+}
+
+template<typename TypeValue>
+void TypedPV<TypeValue>::write_array(const std::vector<TypeValue>& m_values) {
+    caTraceSpan span("put_array", pv->pvName.c_str());
+    std::vector<typename snapshotType<TypeValue>::wire> wire(m_values.size());
+    for (std::size_t i = 0; i < m_values.size(); i++) {
+        if constexpr (std::is_same_v<TypeValue, std::string>) {
+            std::strncpy(wire[i], m_values[i].c_str(), sizeof(wire[i]) - 1);
+        } else {
+            wire[i] = static_cast<typename snapshotType<TypeValue>::wire>(m_values[i]);
+        }
+    }
+    unsigned long count = static_cast<unsigned long>(wire.size());
+    if (pv->coalescer != nullptr) {
+        pv->coalescer->write(writeType, count, wire.data());
+        return;
+    }
+    uint64_t start = caLatencyStats::now();
+    int status = get_transport()->array_put(writeType, count, pv->channel, wire.data());
+    span.set_status(status);
+    SEVCHK(status, ("Failed to put value to PV " + pv->pvName).c_str());
+    span.set_status(pv->_complete_put(writeType, count, start));
+}
+
+template<typename TypeValue>
+void TypedPV<TypeValue>::add_monitor(typedCallback m_callback, void* m_usr) {
+    auto hook = std::make_unique<typedHook>();
+    hook->pv = pv;
+    hook->convert = convert;
+    hook->callback = m_callback;
+    hook->usr = m_usr;
+    hook->subscription = caChannelTable::instance().subscribe(pv->get_shared_channel(), readType, 1, DBE_VALUE,
+                                                              monitor_callback, hook.get());
+    pv->_pend_io("Failed to add monitor for PV ");
+    monitors.push_back(std::move(hook));
+}
+
+template<typename TypeValue>
+void TypedPV<TypeValue>::remove_monitors() {
+    for (auto& hook : monitors) {
+        caChannelTable::instance().unsubscribe(hook->subscription, hook.get());
+    }
+    monitors.clear();
+}
+
+template<typename TypeValue>
+void TypedPV<TypeValue>::monitor_callback(struct event_handler_args args) {
+    typedHook* hook = static_cast<typedHook*>(args.usr);
+    if (args.status != ECA_NORMAL || args.dbr == nullptr) {
+        return;
+    }
+    hook->pv->counters.monitorEvents.add();
+    hook->pv->counters.bytesReceived.add(args.count * dbr_value_size[args.type]);
+    caTraceSpan span("monitor", hook->pv->pvName.c_str());
+    TypeValue value;
+    hook->convert(args.dbr, &value, 1);
+    hook->callback(value, hook->usr);
+}
+
+//Instantiate the template class for allowed types
+template class TypedPV<double>;
+template class TypedPV<float>;
+template class TypedPV<int>;
+template class TypedPV<short>;
+template class TypedPV<char>;
+template class TypedPV<long>;
+template class TypedPV<std::string>;
+} // namespace epics
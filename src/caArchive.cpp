@@ -0,0 +1,473 @@
+/**
+ * @file caArchive.cpp
+ * @brief Implementation of the compressed columnar archive writer and reader.
+ */
+
+#include "caArchive.h"
+#include "caRecorder.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+namespace epics {
+
+static const char archiveMagic[8] = {'E', 'P', 'A', 'R', 'C', 'H', '0', '1'};
+static const char archiveEndMagic[8] = {'E', 'P', 'A', 'R', 'E', 'N', 'D', '1'};
+static const uint32_t archiveBlockMagic = 0x4b4c4245;   //"EBLK"
+static const uint32_t archiveIndexMagic = 0x58444945;   //"EIDX"
+
+static const int64_t nsPerSecond = 1000000000;
+
+//MSB-first bit packing into a byte vector
+class bitWriter {
+    private:
+    uint64_t acc = 0;
+    int used = 0;
+
+    public:
+    std::vector<uint8_t> bytes;
+
+    void write(uint64_t value, int nbits) {
+        if (nbits > 32) {
+            write(value >> 32, nbits - 32);
+            write(value & 0xffffffffULL, 32);
+            return;
+        }
+        value &= (1ULL << nbits) - 1;
+        acc = (acc << nbits) | value;
+        used += nbits;
+        while (used >= 8) {
+            bytes.push_back(static_cast<uint8_t>(acc >> (used - 8)));
+            used -= 8;
+        }
+        acc &= (1ULL << used) - 1;
+    }
+
+    void finish() {
+        if (used > 0) {
+            bytes.push_back(static_cast<uint8_t>(acc << (8 - used)));
+        }
+        acc = 0;
+        used = 0;
+    }
+
+    void clear() {
+        bytes.clear();
+        acc = 0;
+        used = 0;
+    }
+};
+
+class bitReader {
+    private:
+    const uint8_t* data;
+    std::size_t size;
+    std::size_t pos = 0;
+    uint64_t acc = 0;
+    int have = 0;
+
+    public:
+    bitReader(const uint8_t* m_data, std::size_t m_size) : data(m_data), size(m_size) {}
+
+    uint64_t read(int nbits) {
+        if (nbits > 32) {
+            uint64_t high = read(nbits - 32);
+            return (high << 32) | read(32);
+        }
+        while (have < nbits) {
+            if (pos >= size) {
+                throw std::runtime_error("Archive block is truncated");
+            }
+            acc = (acc << 8) | data[pos++];
+            have += 8;
+        }
+        uint64_t value = (acc >> (have - nbits)) & ((1ULL << nbits) - 1);
+        have -= nbits;
+        acc &= (1ULL << have) - 1;
+        return value;
+    }
+
+    bool bit() {return read(1) != 0;}
+};
+
+static int64_t sign_extend(uint64_t value, int nbits) {
+    uint64_t sign = 1ULL << (nbits - 1);
+    return static_cast<int64_t>((value ^ sign) - sign);
+}
+
+static bool fits(int64_t value, int nbits) {
+    int64_t limit = int64_t(1) << (nbits - 1);
+    return value >= -limit && value < limit;
+}
+
+struct caArchiveWriter::encoder {
+    bitWriter timestamps;
+    bitWriter values;
+    uint32_t count = 0;
+    int64_t firstTimestamp = 0;
+    int64_t lastTimestamp = 0;
+    int64_t lastDelta = 0;
+    uint64_t lastBits = 0;
+    int lastLeading = -1;
+    int lastTrailing = 0;
+
+    void add(int64_t timestamp, double value) {
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        if (count == 0) {
+            timestamps.write(static_cast<uint64_t>(timestamp), 64);
+            values.write(bits, 64);
+            firstTimestamp = timestamp;
+            lastDelta = 0;
+            lastLeading = -1;
+        } else {
+            //Delta-of-delta in nanoseconds. The buckets cover scan jitter up to the
+            //microsecond range before falling back to the full 64 bits.
+            int64_t delta = timestamp - lastTimestamp;
+            int64_t dod = delta - lastDelta;
+            if (dod == 0) {
+                timestamps.write(0b0, 1);
+            } else if (fits(dod, 14)) {
+                timestamps.write(0b10, 2);
+                timestamps.write(static_cast<uint64_t>(dod), 14);
+            } else if (fits(dod, 20)) {
+                timestamps.write(0b110, 3);
+                timestamps.write(static_cast<uint64_t>(dod), 20);
+            } else if (fits(dod, 32)) {
+                timestamps.write(0b1110, 4);
+                timestamps.write(static_cast<uint64_t>(dod), 32);
+            } else {
+                timestamps.write(0b1111, 4);
+                timestamps.write(static_cast<uint64_t>(dod), 64);
+            }
+            lastDelta = delta;
+
+            uint64_t x = bits ^ lastBits;
+            if (x == 0) {
+                values.write(0b0, 1);
+            } else {
+                int leading = std::min(__builtin_clzll(x), 31);
+                int trailing = __builtin_ctzll(x);
+                if (lastLeading >= 0 && leading >= lastLeading && trailing >= lastTrailing) {
+                    //Meaningful bits fit in the previous window
+                    values.write(0b10, 2);
+                    values.write(x >> lastTrailing, 64 - lastLeading - lastTrailing);
+                } else {
+                    int significant = 64 - leading - trailing;
+                    values.write(0b11, 2);
+                    values.write(static_cast<uint64_t>(leading), 5);
+                    values.write(static_cast<uint64_t>(significant & 63), 6);
+                    values.write(x >> trailing, significant);
+                    lastLeading = leading;
+                    lastTrailing = trailing;
+                }
+            }
+        }
+        lastTimestamp = timestamp;
+        lastBits = bits;
+        count++;
+    }
+
+    void reset() {
+        timestamps.clear();
+        values.clear();
+        count = 0;
+    }
+};
+
+caArchiveWriter::caArchiveWriter(std::string m_path, std::vector<std::string> m_pvNames,
+                                 uint32_t m_blockSize, uint32_t m_indexInterval) {
+    path = m_path;
+    blockSize = m_blockSize == 0 ? 1 : m_blockSize;
+    indexInterval = m_indexInterval == 0 ? 1 : m_indexInterval;
+    file = std::fopen(path.c_str(), "wb");
+    if (file == nullptr) {
+        throw std::runtime_error("Failed to open archive file " + path + ": " + std::strerror(errno));
+    }
+
+    archiveFileHeader header = {};
+    std::memcpy(header.magic, archiveMagic, sizeof(archiveMagic));
+    header.version = 1;
+    header.pv_count = static_cast<uint32_t>(m_pvNames.size());
+    header.name_size = name_size;
+    header.block_size = blockSize;
+    _write(&header, sizeof(header));
+    for (auto m_pvName : m_pvNames) {
+        char name[name_size] = {};
+        std::strncpy(name, m_pvName.c_str(), name_size - 1);
+        _write(name, name_size);
+        encoders.push_back(new encoder());
+    }
+}
+
+caArchiveWriter::~caArchiveWriter() {
+    if (file != nullptr) {
+        try {
+            close();
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << std::endl;
+        }
+    }
+    for (encoder* m_encoder : encoders) {
+        delete m_encoder;
+    }
+}
+
+void caArchiveWriter::_write(const void* data, std::size_t bytes) {
+    if (std::fwrite(data, 1, bytes, file) != bytes) {
+        throw std::runtime_error("Failed to write archive file " + path + ": " + std::strerror(errno));
+    }
+    bytesWritten += bytes;
+}
+
+void caArchiveWriter::append(uint32_t pv_index, int64_t timestamp, double value) {
+    if (file == nullptr) {
+        throw std::runtime_error("Archive file " + path + " is closed");
+    }
+    if (pv_index >= encoders.size()) {
+        throw std::runtime_error("Archive PV index " + std::to_string(pv_index) + " out of range");
+    }
+    encoder* m_encoder = encoders[pv_index];
+    m_encoder->add(timestamp, value);
+    samplesWritten++;
+    if (m_encoder->count >= blockSize) {
+        _write_block(pv_index);
+    }
+}
+
+bool caArchiveWriter::append(const ringRecord& record) {
+    if (record.count != 1 || record.dbr_type == DBR_STRING) {
+        return false;
+    }
+    int64_t timestamp = static_cast<int64_t>(record.sec_past_epoch) * nsPerSecond + record.nsec;
+    append(record.pv_index, timestamp, caRingReader::value_as_double(record));
+    return true;
+}
+
+void caArchiveWriter::_write_block(uint32_t pv_index) {
+    encoder* m_encoder = encoders[pv_index];
+    if (m_encoder->count == 0) {
+        return;
+    }
+    m_encoder->timestamps.finish();
+    m_encoder->values.finish();
+
+    archiveBlockHeader header = {};
+    header.magic = archiveBlockMagic;
+    header.pv_index = pv_index;
+    header.count = m_encoder->count;
+    header.timestamp_bytes = static_cast<uint32_t>(m_encoder->timestamps.bytes.size());
+    header.value_bytes = static_cast<uint32_t>(m_encoder->values.bytes.size());
+    header.first_timestamp = m_encoder->firstTimestamp;
+    header.last_timestamp = m_encoder->lastTimestamp;
+
+    archiveIndexEntry entry = {pv_index, header.count, header.first_timestamp, header.last_timestamp, bytesWritten};
+    _write(&header, sizeof(header));
+    _write(m_encoder->timestamps.bytes.data(), m_encoder->timestamps.bytes.size());
+    _write(m_encoder->values.bytes.data(), m_encoder->values.bytes.size());
+    m_encoder->reset();
+
+    pendingIndex.push_back(entry);
+    if (pendingIndex.size() >= indexInterval) {
+        _write_index();
+    }
+}
+
+void caArchiveWriter::_write_index() {
+    if (pendingIndex.empty()) {
+        return;
+    }
+    archiveIndexHeader header = {archiveIndexMagic, static_cast<uint32_t>(pendingIndex.size()), lastIndex};
+    lastIndex = bytesWritten;
+    _write(&header, sizeof(header));
+    _write(pendingIndex.data(), pendingIndex.size() * sizeof(archiveIndexEntry));
+    pendingIndex.clear();
+    //An index segment is a good point to make the data durable for readers
+    std::fflush(file);
+}
+
+void caArchiveWriter::close() {
+    if (file == nullptr) {
+        return;
+    }
+    for (uint32_t i = 0; i < encoders.size(); i++) {
+        _write_block(i);
+    }
+    _write_index();
+    archiveFooter footer = {};
+    footer.last_index = lastIndex;
+    std::memcpy(footer.magic, archiveEndMagic, sizeof(archiveEndMagic));
+    _write(&footer, sizeof(footer));
+    std::fclose(file);
+    file = nullptr;
+}
+
+caArchiveReader::caArchiveReader(std::string m_path) {
+    file = std::fopen(m_path.c_str(), "rb");
+    if (file == nullptr) {
+        throw std::runtime_error("Failed to open archive file " + m_path + ": " + std::strerror(errno));
+    }
+    archiveFileHeader header;
+    if (std::fread(&header, sizeof(header), 1, file) != 1 ||
+        std::memcmp(header.magic, archiveMagic, sizeof(archiveMagic)) != 0) {
+        std::fclose(file);
+        throw std::runtime_error("File " + m_path + " is not a PV archive");
+    }
+    std::vector<char> name(header.name_size);
+    for (uint32_t i = 0; i < header.pv_count; i++) {
+        if (std::fread(name.data(), 1, name.size(), file) != name.size()) {
+            std::fclose(file);
+            throw std::runtime_error("Archive file " + m_path + " is truncated");
+        }
+        pvNames.push_back(std::string(name.data(), strnlen(name.data(), name.size())));
+    }
+    uint64_t data_offset = sizeof(header) + static_cast<uint64_t>(header.pv_count) * header.name_size;
+
+    archiveFooter footer;
+    if (std::fseek(file, -static_cast<long>(sizeof(footer)), SEEK_END) == 0 &&
+        std::fread(&footer, sizeof(footer), 1, file) == 1 &&
+        std::memcmp(footer.magic, archiveEndMagic, sizeof(archiveEndMagic)) == 0) {
+        _load_index(footer.last_index);
+        complete = true;
+    } else {
+        _scan_blocks(data_offset);
+    }
+}
+
+caArchiveReader::~caArchiveReader() {
+    std::fclose(file);
+}
+
+//Follow the index segments backwards from the footer
+void caArchiveReader::_load_index(uint64_t last_index) {
+    std::vector<std::vector<archiveIndexEntry>> segments;
+    uint64_t offset = last_index;
+    while (offset != 0) {
+        archiveIndexHeader header;
+        std::fseek(file, static_cast<long>(offset), SEEK_SET);
+        if (std::fread(&header, sizeof(header), 1, file) != 1 || header.magic != archiveIndexMagic) {
+            throw std::runtime_error("Archive index is corrupt");
+        }
+        std::vector<archiveIndexEntry> entries(header.count);
+        if (std::fread(entries.data(), sizeof(archiveIndexEntry), header.count, file) != header.count) {
+            throw std::runtime_error("Archive index is truncated");
+        }
+        segments.push_back(entries);
+        offset = header.previous;
+    }
+    for (auto it = segments.rbegin(); it != segments.rend(); ++it) {
+        blocks.insert(blocks.end(), it->begin(), it->end());
+    }
+}
+
+//Rebuild the block list from an archive whose writer did not close it
+void caArchiveReader::_scan_blocks(uint64_t offset) {
+    while (true) {
+        std::fseek(file, static_cast<long>(offset), SEEK_SET);
+        uint32_t magic;
+        if (std::fread(&magic, sizeof(magic), 1, file) != 1) {
+            return;
+        }
+        std::fseek(file, static_cast<long>(offset), SEEK_SET);
+        if (magic == archiveBlockMagic) {
+            archiveBlockHeader header;
+            if (std::fread(&header, sizeof(header), 1, file) != 1) {
+                return;
+            }
+            uint64_t next = offset + sizeof(header) + header.timestamp_bytes + header.value_bytes;
+            //Skip a block whose columns were cut off
+            if (std::fseek(file, static_cast<long>(next - 1), SEEK_SET) != 0 || std::fgetc(file) == EOF) {
+                return;
+            }
+            blocks.push_back({header.pv_index, header.count, header.first_timestamp, header.last_timestamp, offset});
+            offset = next;
+        } else if (magic == archiveIndexMagic) {
+            archiveIndexHeader header;
+            if (std::fread(&header, sizeof(header), 1, file) != 1) {
+                return;
+            }
+            offset += sizeof(header) + static_cast<uint64_t>(header.count) * sizeof(archiveIndexEntry);
+        } else {
+            return;
+        }
+    }
+}
+
+std::vector<archiveSample> caArchiveReader::read(uint32_t pv_index, int64_t begin, int64_t end) {
+    std::vector<archiveSample> result;
+    std::vector<uint8_t> columns;
+    for (const archiveIndexEntry& entry : blocks) {
+        if (entry.pv_index != pv_index || entry.last_timestamp < begin || entry.first_timestamp > end) {
+            continue;
+        }
+        archiveBlockHeader header;
+        std::fseek(file, static_cast<long>(entry.offset), SEEK_SET);
+        if (std::fread(&header, sizeof(header), 1, file) != 1 || header.magic != archiveBlockMagic) {
+            throw std::runtime_error("Archive block is corrupt");
+        }
+        columns.resize(static_cast<std::size_t>(header.timestamp_bytes) + header.value_bytes);
+        if (std::fread(columns.data(), 1, columns.size(), file) != columns.size()) {
+            throw std::runtime_error("Archive block is truncated");
+        }
+        for (const archiveSample& sample : decode_block(header, columns.data())) {
+            if (sample.timestamp >= begin && sample.timestamp <= end) {
+                result.push_back(sample);
+            }
+        }
+    }
+    return result;
+}
+
+std::vector<archiveSample> caArchiveReader::decode_block(const archiveBlockHeader& header, const uint8_t* columns) {
+    std::vector<archiveSample> samples(header.count);
+    if (header.count == 0) {
+        return samples;
+    }
+
+    bitReader timestamps(columns, header.timestamp_bytes);
+    int64_t timestamp = static_cast<int64_t>(timestamps.read(64));
+    int64_t delta = 0;
+    samples[0].timestamp = timestamp;
+    for (uint32_t i = 1; i < header.count; i++) {
+        int64_t dod;
+        if (!timestamps.bit()) {
+            dod = 0;
+        } else if (!timestamps.bit()) {
+            dod = sign_extend(timestamps.read(14), 14);
+        } else if (!timestamps.bit()) {
+            dod = sign_extend(timestamps.read(20), 20);
+        } else if (!timestamps.bit()) {
+            dod = sign_extend(timestamps.read(32), 32);
+        } else {
+            dod = static_cast<int64_t>(timestamps.read(64));
+        }
+        delta += dod;
+        timestamp += delta;
+        samples[i].timestamp = timestamp;
+    }
+
+    bitReader values(columns + header.timestamp_bytes, header.value_bytes);
+    uint64_t bits = values.read(64);
+    int leading = 0;
+    int trailing = 0;
+    std::memcpy(&samples[0].value, &bits, sizeof(bits));
+    for (uint32_t i = 1; i < header.count; i++) {
+        if (values.bit()) {
+            if (values.bit()) {
+                leading = static_cast<int>(values.read(5));
+                int significant = static_cast<int>(values.read(6));
+                if (significant == 0) {
+                    significant = 64;
+                }
+                trailing = 64 - leading - significant;
+            }
+            bits ^= values.read(64 - leading - trailing) << trailing;
+        }
+        std::memcpy(&samples[i].value, &bits, sizeof(bits));
+    }
+    return samples;
+}
+} // namespace epics
@@ -0,0 +1,243 @@
+/**
+ * @file caChannelTable.cpp
+ * @brief Reference-counted channel and subscription sharing across PVs.
+ */
+
+#include "caChannelTable.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace epics {
+
+caChannelTable& caChannelTable::instance() {
+    static caChannelTable table;
+    return table;
+}
+
+//Channels are created under the table lock so a second acquire never sees one half made.
+//CA runs connection handlers on its own threads, which only take the channel lock.
+sharedChannel* caChannelTable::acquire(std::string m_name, unsigned m_priority, channelUser m_user) {
+    struct ca_client_context* m_context = get_transport()->current_context();
+    std::lock_guard<std::mutex> lock(mutex);
+    auto found = channels.find(channelKey{m_context, m_name});
+    if (found != channels.end()) {
+        sharedChannel* m_channel = found->second;
+        std::lock_guard<std::mutex> channelLock(m_channel->mutex);
+        m_channel->users.push_back(m_user);
+        if (m_channel->connected) {
+            m_user.on_state(m_user.usr, true);
+        }
+        return m_channel;
+    }
+    sharedChannel* m_channel = new sharedChannel();
+    m_channel->name = m_name;
+    m_channel->context = m_context;
+    m_channel->users.push_back(m_user);
+    int status = get_transport()->create_channel(m_name.c_str(), connection_callback, m_channel, m_priority, &m_channel->channel);
+    if (status != ECA_NORMAL) {
+        delete m_channel;
+        //SEVCHK returns for errors that are not fatal, and callers need a channel
+        SEVCHK(status, ("Failed to create channel for PV " + m_name).c_str());
+        throw std::runtime_error("Failed to create channel for PV " + m_name);
+    }
+    channels.emplace(channelKey{m_context, m_name}, m_channel);
+    return m_channel;
+}
+
+void caChannelTable::release(sharedChannel* m_channel, void* m_usr) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::lock_guard<std::mutex> channelLock(m_channel->mutex);
+        auto user = std::find_if(m_channel->users.begin(), m_channel->users.end(),
+                                 [m_usr](const channelUser& m_user) {return m_user.usr == m_usr;});
+        if (user != m_channel->users.end()) {
+            m_channel->users.erase(user);
+        }
+        if (!m_channel->users.empty()) {
+            return;
+        }
+        channels.erase(channelKey{m_channel->context, m_channel->name});
+    }
+    //Last user gone. Clearing the channel also clears any subscription left on it, and
+    //cancels the callbacks the leftovers were kept for.
+    SEVCHK(get_transport()->clear_channel(m_channel->channel), ("Failed to destroy channel for PV " + m_channel->name).c_str());
+    delete m_channel;
+}
+
+void caChannelTable::keep_until_cleared(sharedChannel* m_channel, std::shared_ptr<void> m_object) {
+    std::lock_guard<std::mutex> channelLock(m_channel->mutex);
+    m_channel->leftovers.push_back(std::move(m_object));
+}
+
+//Subscription whose events this thread is delivering, so removing a subscriber from a
+//callback does not wait for itself
+static thread_local sharedSubscription* delivering = nullptr;
+
+//A late subscriber's one-shot get
+struct lateJoin {
+    std::shared_ptr<sharedSubscription> subscription;
+    caEventCallBackFunc* callback;
+    void* usr;
+};
+
+//The subscriber is registered before CA is asked for the subscription, so the first
+//event cannot be missed
+sharedSubscription* caChannelTable::subscribe(sharedChannel* m_channel, chtype m_type, unsigned long m_count, long m_mask,
+                                              caEventCallBackFunc* m_callback, void* m_usr) {
+    std::lock_guard<std::mutex> channelLock(m_channel->mutex);
+    for (auto& m_subscription : m_channel->subscriptions) {
+        if (m_subscription->type == m_type && m_subscription->count == m_count && m_subscription->mask == m_mask) {
+            bool late;
+            {
+                std::lock_guard<std::mutex> lock(m_subscription->mutex);
+                auto m_subscribers = std::make_shared<subscriberList>(*m_subscription->subscribers);
+                m_subscribers->emplace_back(m_callback, m_usr);
+                m_subscription->subscribers = m_subscribers;
+                late = m_subscription->delivered;
+            }
+            if (late) {
+                lateJoin* join = new lateJoin{m_subscription, m_callback, m_usr};
+                int status = get_transport()->array_get_callback(m_type, m_count, m_channel->channel, join_callback, join);
+                if (status != ECA_NORMAL) {
+                    delete join;
+                }
+                SEVCHK(status, ("Failed to add monitor for PV " + m_channel->name).c_str());
+            }
+            return m_subscription.get();
+        }
+    }
+    auto m_subscription = std::make_shared<sharedSubscription>();
+    m_subscription->owner = m_channel;
+    m_subscription->type = m_type;
+    m_subscription->count = m_count;
+    m_subscription->mask = m_mask;
+    m_subscription->subscribers = std::make_shared<subscriberList>(1, std::make_pair(m_callback, m_usr));
+    int status = get_transport()->create_subscription(m_type, m_count, m_channel->channel, m_mask, event_callback,
+                                                      m_subscription.get(), &m_subscription->monitor);
+    if (status != ECA_NORMAL) {
+        //Not kept, so no later subscriber shares a subscription that never delivers
+        SEVCHK(status, ("Failed to add monitor for PV " + m_channel->name).c_str());
+        throw std::runtime_error("Failed to add monitor for PV " + m_channel->name);
+    }
+    m_channel->subscriptions.push_back(m_subscription);
+    return m_subscription.get();
+}
+
+//The CA subscription is cleared outside the channel lock, since CA waits there for an
+//event in progress whose callbacks may want the channel
+void caChannelTable::unsubscribe(sharedSubscription* m_subscription, void* m_usr) {
+    sharedChannel* m_channel = m_subscription->owner;
+    std::shared_ptr<sharedSubscription> keep;
+    bool last;
+    {
+        std::lock_guard<std::mutex> channelLock(m_channel->mutex);
+        std::lock_guard<std::mutex> lock(m_subscription->mutex);
+        keep = m_subscription->shared_from_this();
+        auto m_subscribers = std::make_shared<subscriberList>(*m_subscription->subscribers);
+        auto subscriber = std::find_if(m_subscribers->begin(), m_subscribers->end(),
+                                       [m_usr](const std::pair<caEventCallBackFunc*, void*>& m_entry) {return m_entry.second == m_usr;});
+        if (subscriber != m_subscribers->end()) {
+            m_subscribers->erase(subscriber);
+        }
+        m_subscription->subscribers = m_subscribers;
+        last = m_subscribers->empty();
+        if (last) {
+            std::erase(m_channel->subscriptions, keep);
+        }
+    }
+    if (last) {
+        SEVCHK(get_transport()->clear_subscription(m_subscription->monitor), ("Failed to remove monitor for PV " + m_channel->name).c_str());
+    }
+    //Deliveries that took an older list may still be on their way to m_usr. A callback
+    //of this subscription cannot wait for them, since they may be waiting for it.
+    if (delivering != m_subscription) {
+        std::unique_lock<std::mutex> lock(m_subscription->mutex);
+        m_subscription->released.wait(lock, [m_subscription]() {return !m_subscription->retiring;});
+        m_subscription->retiring = true;
+        unsigned current = m_subscription->epoch & 1;
+        m_subscription->released.wait(lock, [m_subscription, current]() {return m_subscription->active[current ^ 1] == 0;});
+        m_subscription->epoch++;
+        m_subscription->released.wait(lock, [m_subscription, current]() {return m_subscription->active[current] == 0;});
+        m_subscription->retiring = false;
+        m_subscription->released.notify_all();
+    }
+}
+
+void* caChannelTable::first_user(chid m_channel) {
+    sharedChannel* m_shared = static_cast<sharedChannel*>(get_transport()->puser(m_channel));
+    std::lock_guard<std::mutex> channelLock(m_shared->mutex);
+    return m_shared->users.empty() ? nullptr : m_shared->users.front().usr;
+}
+
+channelTableStats caChannelTable::stats() {
+    channelTableStats m_stats;
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& entry : channels) {
+        std::lock_guard<std::mutex> channelLock(entry.second->mutex);
+        m_stats.channels++;
+        m_stats.users += entry.second->users.size();
+        for (auto& m_subscription : entry.second->subscriptions) {
+            std::lock_guard<std::mutex> subscriptionLock(m_subscription->mutex);
+            m_stats.subscriptions++;
+            m_stats.subscribers += m_subscription->subscribers->size();
+        }
+    }
+    return m_stats;
+}
+
+void caChannelTable::connection_callback(struct connection_handler_args args) {
+    sharedChannel* m_channel = static_cast<sharedChannel*>(get_transport()->puser(args.chid));
+    bool m_connected = args.op == CA_OP_CONN_UP;
+    std::lock_guard<std::mutex> channelLock(m_channel->mutex);
+    m_channel->connected = m_connected;
+    for (channelUser& m_user : m_channel->users) {
+        m_user.on_state(m_user.usr, m_connected);
+    }
+}
+
+//Pass an event to the subscribers, or to the one subscriber m_only with usr args.usr
+void caChannelTable::_deliver(sharedSubscription* m_subscription, struct event_handler_args args, caEventCallBackFunc* m_only) {
+    //A callback removing the last subscriber must not free the subscription under us
+    std::shared_ptr<sharedSubscription> keep;
+    std::shared_ptr<const subscriberList> m_subscribers;
+    unsigned slot;
+    {
+        std::lock_guard<std::mutex> lock(m_subscription->mutex);
+        keep = m_subscription->shared_from_this();
+        m_subscribers = m_subscription->subscribers;
+        slot = m_subscription->epoch & 1;
+        m_subscription->active[slot]++;
+        if (m_only == nullptr && args.status == ECA_NORMAL) {
+            m_subscription->delivered = true;
+        }
+    }
+    sharedSubscription* outer = delivering;
+    delivering = m_subscription;
+    void* m_usr = args.usr;
+    for (const auto& subscriber : *m_subscribers) {
+        if (m_only == nullptr || (subscriber.first == m_only && subscriber.second == m_usr)) {
+            args.usr = subscriber.second;
+            subscriber.first(args);
+        }
+    }
+    delivering = outer;
+    {
+        std::lock_guard<std::mutex> lock(m_subscription->mutex);
+        m_subscribers.reset();
+        m_subscription->active[slot]--;
+        m_subscription->released.notify_all();
+    }
+}
+
+void caChannelTable::event_callback(struct event_handler_args args) {
+    _deliver(static_cast<sharedSubscription*>(args.usr), args, nullptr);
+}
+
+//The current value for a late subscriber, unless it has left already
+void caChannelTable::join_callback(struct event_handler_args args) {
+    std::unique_ptr<lateJoin> join(static_cast<lateJoin*>(args.usr));
+    args.usr = join->usr;
+    _deliver(join->subscription.get(), args, join->callback);
+}
+} // namespace epics
@@ -0,0 +1,148 @@
+/**
+ * @file caChunkedArray.cpp
+ * @brief Piecewise array reads through array filter channels and piecewise writes.
+ */
+
+#include "caChunkedArray.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <stdexcept>
+
+namespace epics {
+
+caChunkedArray::caChunkedArray(std::string m_pvName, unsigned m_priority, chunkConfig m_config, caCounters* m_stats) {
+    pvName = m_pvName;
+    priority = m_priority;
+    config = m_config;
+    stats = m_stats;
+    if (config.chunk_bytes == 0) {
+        const char* limit = std::getenv("EPICS_CA_MAX_ARRAY_BYTES");
+        config.chunk_bytes = limit != nullptr ? std::strtoul(limit, nullptr, 10) : 16384;
+    }
+    if (config.in_flight == 0) {
+        config.in_flight = 1;
+    }
+}
+
+caChunkedArray::~caChunkedArray() {
+    _release();
+    if (offsetChannel != nullptr) {
+        caChannelTable::instance().release(offsetChannel, this);
+    }
+    if (dataChannel != nullptr) {
+        caChannelTable::instance().release(dataChannel, this);
+    }
+}
+
+//Filter channels are polled through sharedChannel::connected, so nothing to do here
+void caChunkedArray::piece_state(void*, bool) {
+}
+
+void caChunkedArray::_release() {
+    for (sharedChannel* piece : pieces) {
+        caChannelTable::instance().release(piece, this);
+    }
+    pieces.clear();
+    pieceElements = 0;
+    totalElements = 0;
+}
+
+void caChunkedArray::_wait_connected(std::vector<sharedChannel*> m_channels, std::string m_message) {
+    SEVCHK(get_transport()->flush_io(), (m_message + pvName).c_str());
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    for (sharedChannel* m_channel : m_channels) {
+        while (!m_channel->connected && std::chrono::steady_clock::now() < deadline) {
+            get_transport()->pend_event(0.001);
+        }
+        if (!m_channel->connected) {
+            if (stats != nullptr) {
+                stats->timeouts.add();
+            }
+            throw std::runtime_error(m_message + pvName + ": " + m_channel->name + " did not connect");
+        }
+    }
+}
+
+void caChunkedArray::_pend_io(std::string m_message) {
+    int status = get_transport()->pend_io(5.0);
+    if (status == ECA_TIMEOUT && stats != nullptr) {
+        stats->timeouts.add();
+    }
+    SEVCHK(status, (m_message + pvName).c_str());
+}
+
+//Make one filter channel per piece, or keep the ones of the same layout
+void caChunkedArray::_layout(unsigned long m_pieceElements, unsigned long m_totalElements) {
+    if (m_pieceElements == pieceElements && m_totalElements == totalElements) {
+        return;
+    }
+    _release();
+    //"dev:wf" takes the filter as "dev:wf.[a:b]", "dev:wf.VAL" as "dev:wf.VAL[a:b]"
+    std::string base = pvName.find('.') == std::string::npos ? pvName + "." : pvName;
+    for (unsigned long first = 0; first < m_totalElements; first += m_pieceElements) {
+        unsigned long last = std::min(first + m_pieceElements, m_totalElements) - 1;
+        std::string name = base + "[" + std::to_string(first) + ":" + std::to_string(last) + "]";
+        pieces.push_back(caChannelTable::instance().acquire(name, priority, channelUser{piece_state, this}));
+    }
+    pieceElements = m_pieceElements;
+    totalElements = m_totalElements;
+    _wait_connected(pieces, "Failed to connect array filter channels for PV ");
+}
+
+unsigned long caChunkedArray::piece_elements(chtype m_type) {
+    unsigned long elements = static_cast<unsigned long>(config.chunk_bytes / dbr_value_size[m_type]);
+    return std::max(elements, 1UL);
+}
+
+bool caChunkedArray::needs_pieces(chtype m_type, unsigned long m_count) {
+    return m_count > piece_elements(m_type);
+}
+
+void caChunkedArray::read(chtype m_type, unsigned long m_count, void* m_dest) {
+    unsigned long step = piece_elements(m_type);
+    _layout(step, m_count);
+    char* out = static_cast<char*>(m_dest);
+    std::size_t index = 0;
+    while (index < pieces.size()) {
+        //Request a window of pieces, then wait for all of them at once
+        std::size_t end = std::min(index + config.in_flight, pieces.size());
+        for (; index < end; index++) {
+            unsigned long first = index * step;
+            unsigned long count = std::min(step, m_count - first);
+            SEVCHK(get_transport()->array_get(m_type, count, pieces[index]->channel, out + first * dbr_value_size[m_type]),
+                   ("Failed to get value from PV " + pvName).c_str());
+        }
+        _pend_io("Failed to get value from PV ");
+    }
+}
+
+void caChunkedArray::write(chtype m_type, unsigned long m_count, const void* m_src) {
+    if (!can_write()) {
+        throw std::runtime_error("PV " + pvName + " has no offset and data records for piecewise writes");
+    }
+    if (offsetChannel == nullptr) {
+        offsetChannel = caChannelTable::instance().acquire(config.offset_pv, priority, channelUser{piece_state, this});
+        dataChannel = caChannelTable::instance().acquire(config.data_pv, priority, channelUser{piece_state, this});
+    }
+    _wait_connected({offsetChannel, dataChannel}, "Failed to connect offset and data records for PV ");
+    unsigned long step = piece_elements(m_type);
+    const char* in = static_cast<const char*>(m_src);
+    unsigned queued = 0;
+    for (unsigned long first = 0; first < m_count; first += step) {
+        unsigned long count = std::min(step, m_count - first);
+        dbr_long_t offset = static_cast<dbr_long_t>(first);
+        SEVCHK(get_transport()->array_put(DBR_LONG, 1, offsetChannel->channel, &offset), ("Failed to put value to PV " + pvName).c_str());
+        SEVCHK(get_transport()->array_put(m_type, count, dataChannel->channel, in + first * dbr_value_size[m_type]),
+               ("Failed to put value to PV " + pvName).c_str());
+        if (++queued == config.in_flight) {
+            _pend_io("Failed to put value to PV ");
+            queued = 0;
+        }
+    }
+    if (queued != 0) {
+        _pend_io("Failed to put value to PV ");
+    }
+}
+} // namespace epics
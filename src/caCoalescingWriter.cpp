@@ -0,0 +1,125 @@
+/**
+ * @file caCoalescingWriter.cpp
+ * @brief Implementation of the superseded-setpoint coalescing writer.
+ */
+
+#include "caCoalescingWriter.h"
+
+#include <cstring>
+#include <chrono>
+
+namespace epics {
+
+caCoalescingWriter::caCoalescingWriter(chid m_channel, std::string m_pvName, caLatencyStats* m_latency, caCounters* m_stats) {
+    channel = m_channel;
+    pvName = m_pvName;
+    latency = m_latency;
+    stats = m_stats;
+}
+
+void caCoalescingWriter::set_write_buffer(caWriteBuffer* m_writeBuffer) {
+    std::lock_guard<std::mutex> lock(mutex);
+    writeBuffer = m_writeBuffer;
+}
+
+void caCoalescingWriter::write(chtype type, unsigned long count, const void* value) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (hasPending) {
+        counters.dropped++;
+    }
+    std::size_t bytes = count * dbr_value_size[type];
+    pending.resize(bytes);
+    std::memcpy(pending.data(), value, bytes);
+    pendingType = type;
+    pendingCount = count;
+    hasPending = true;
+    if (!inFlight) {
+        _send(false);
+    }
+}
+
+//Caller must hold the mutex and have a pending value
+void caCoalescingWriter::_send(bool from_callback) {
+    sentAt = caLatencyStats::now();
+    int status = get_transport()->array_put_callback(pendingType, pendingCount, channel, pending.data(), put_callback, this);
+    SEVCHK(status, ("Failed to put value to PV " + pvName).c_str());
+    if (status != ECA_NORMAL) {
+        //No callback will come; keep the value for resend() after a reconnect
+        return;
+    }
+    hasPending = false;
+    inFlight = true;
+    counters.sent++;
+    counters.in_flight = 1;
+    if (stats != nullptr) {
+        stats->puts.add();
+        stats->bytesSent.add(dbr_size_n(pendingType, pendingCount));
+    }
+    if (writeBuffer != nullptr && !from_callback) {
+        writeBuffer->queued(dbr_size_n(pendingType, pendingCount));
+    } else {
+        SEVCHK(get_transport()->flush_io(), ("Failed to put value to PV " + pvName).c_str());
+    }
+}
+
+//Runs on the CA callback thread when the IOC has processed the put
+void caCoalescingWriter::put_callback(struct event_handler_args args) {
+    caCoalescingWriter* writer = static_cast<caCoalescingWriter*>(args.usr);
+    std::unique_lock<std::mutex> lock(writer->mutex);
+    if (writer->orphaned) {
+        writer->inFlight = false;
+        writer->counters.in_flight = 0;
+        return;
+    }
+    if (args.status != ECA_NORMAL) {
+        writer->counters.failed++;
+    }
+    //A put lost to a disconnect is sent again on reconnect, unless a newer value replaced it
+    if (args.status == ECA_DISCONN && !writer->hasPending) {
+        writer->hasPending = true;
+    }
+    if (writer->latency != nullptr) {
+        writer->latency->record(LATENCY_PUT_CALLBACK, writer->sentAt);
+    }
+    writer->inFlight = false;
+    writer->counters.in_flight = 0;
+    if (writer->hasPending && args.status != ECA_DISCONN) {
+        writer->_send(true);
+    }
+    if (!writer->inFlight) {
+        writer->idle.notify_all();
+    }
+}
+
+void caCoalescingWriter::resend() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (hasPending && !inFlight && !orphaned) {
+        _send(true);
+    }
+}
+
+bool caCoalescingWriter::retire(caCoalescingWriter* m_writer, double m_timeout) {
+    if (m_writer == nullptr) {
+        return true;
+    }
+    get_transport()->flush_io();
+    {
+        std::unique_lock<std::mutex> lock(m_writer->mutex);
+        if (!m_writer->idle.wait_for(lock, std::chrono::duration<double>(m_timeout), [m_writer]() {return !m_writer->inFlight;})) {
+            m_writer->orphaned = true;
+            m_writer->hasPending = false;
+            m_writer->writeBuffer = nullptr;
+            m_writer->latency = nullptr;
+            m_writer->stats = nullptr;
+            return false;
+        }
+    }
+    delete m_writer;
+    return true;
+}
+
+coalescingCounters caCoalescingWriter::get_counters() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return counters;
+}
+} // namespace epics
@@ -0,0 +1,319 @@
+/**
+ * @file caConvert.cpp
+ * @brief Scalar, AVX2 and AVX-512 kernels converting CA array buffers to double.
+ */
+
+#include "caConvert.h"
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define EPICS_PROXY_SIMD_X86
+#include <immintrin.h>
+#endif
+
+namespace epics {
+
+template<typename From, bool Scaled>
+static void scalar_kernel(const From* m_src, double* m_dst, std::size_t m_count, double m_scale, double m_offset) {
+    for (std::size_t i = 0; i < m_count; i++) {
+        double value = static_cast<double>(m_src[i]);
+        if constexpr (Scaled) {
+            value = value * m_scale + m_offset;
+        }
+        m_dst[i] = value;
+    }
+}
+
+//Fold elements m_first to m_count into m_stats
+template<typename From>
+static void scalar_reduce(const From* m_src, std::size_t m_first, std::size_t m_count, arrayStats& m_stats) {
+    for (std::size_t i = m_first; i < m_count; i++) {
+        double value = static_cast<double>(m_src[i]);
+        m_stats.min = std::min(m_stats.min, value);
+        m_stats.max = std::max(m_stats.max, value);
+        m_stats.sum += value;
+        m_stats.weighted += value * static_cast<double>(i);
+    }
+}
+
+//Fold the lanes of the vector accumulators into m_stats
+static void fold_lanes(const double* m_min, const double* m_max, const double* m_sum, const double* m_weighted,
+                       std::size_t m_lanes, arrayStats& m_stats) {
+    for (std::size_t lane = 0; lane < m_lanes; lane++) {
+        m_stats.min = std::min(m_stats.min, m_min[lane]);
+        m_stats.max = std::max(m_stats.max, m_max[lane]);
+        m_stats.sum += m_sum[lane];
+        m_stats.weighted += m_weighted[lane];
+    }
+}
+
+#ifdef EPICS_PROXY_SIMD_X86
+//AVX2: four doubles per step
+__attribute__((target("avx2"))) static inline __m256d load4(const dbr_double_t* m_src) {
+    return _mm256_loadu_pd(m_src);
+}
+__attribute__((target("avx2"))) static inline __m256d load4(const dbr_float_t* m_src) {
+    return _mm256_cvtps_pd(_mm_loadu_ps(m_src));
+}
+__attribute__((target("avx2"))) static inline __m256d load4(const dbr_long_t* m_src) {
+    return _mm256_cvtepi32_pd(_mm_loadu_si128(reinterpret_cast<const __m128i*>(m_src)));
+}
+__attribute__((target("avx2"))) static inline __m256d load4(const dbr_short_t* m_src) {
+    return _mm256_cvtepi32_pd(_mm_cvtepi16_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(m_src))));
+}
+__attribute__((target("avx2"))) static inline __m256d load4(const dbr_enum_t* m_src) {
+    return _mm256_cvtepi32_pd(_mm_cvtepu16_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(m_src))));
+}
+__attribute__((target("avx2"))) static inline __m256d load4(const dbr_char_t* m_src) {
+    int bytes;
+    std::memcpy(&bytes, m_src, sizeof(bytes));
+    return _mm256_cvtepi32_pd(_mm_cvtepu8_epi32(_mm_cvtsi32_si128(bytes)));
+}
+
+template<typename From, bool Scaled>
+__attribute__((target("avx2"))) static void avx2_kernel(const From* m_src, double* m_dst, std::size_t m_count, double m_scale, double m_offset) {
+    __m256d scale = _mm256_set1_pd(m_scale);
+    __m256d offset = _mm256_set1_pd(m_offset);
+    std::size_t i = 0;
+    for (; i + 4 <= m_count; i += 4) {
+        __m256d value = load4(m_src + i);
+        if constexpr (Scaled) {
+            value = _mm256_add_pd(_mm256_mul_pd(value, scale), offset);
+        }
+        _mm256_storeu_pd(m_dst + i, value);
+    }
+    scalar_kernel<From, Scaled>(m_src + i, m_dst + i, m_count - i, m_scale, m_offset);
+}
+
+template<typename From>
+__attribute__((target("avx2"))) static void avx2_reduce(const From* m_src, std::size_t m_count, arrayStats& m_stats) {
+    __m256d low = _mm256_set1_pd(std::numeric_limits<double>::infinity());
+    __m256d high = _mm256_set1_pd(-std::numeric_limits<double>::infinity());
+    __m256d sum = _mm256_setzero_pd();
+    __m256d weighted = _mm256_setzero_pd();
+    __m256d index = _mm256_set_pd(3.0, 2.0, 1.0, 0.0);
+    __m256d step = _mm256_set1_pd(4.0);
+    std::size_t i = 0;
+    for (; i + 4 <= m_count; i += 4) {
+        __m256d value = load4(m_src + i);
+        low = _mm256_min_pd(low, value);
+        high = _mm256_max_pd(high, value);
+        sum = _mm256_add_pd(sum, value);
+        weighted = _mm256_add_pd(weighted, _mm256_mul_pd(value, index));
+        index = _mm256_add_pd(index, step);
+    }
+    alignas(32) double lanes[4][4];
+    _mm256_store_pd(lanes[0], low);
+    _mm256_store_pd(lanes[1], high);
+    _mm256_store_pd(lanes[2], sum);
+    _mm256_store_pd(lanes[3], weighted);
+    fold_lanes(lanes[0], lanes[1], lanes[2], lanes[3], 4, m_stats);
+    scalar_reduce(m_src, i, m_count, m_stats);
+}
+
+//AVX-512: eight doubles per step
+__attribute__((target("avx512f"))) static inline __m512d load8(const dbr_double_t* m_src) {
+    return _mm512_loadu_pd(m_src);
+}
+__attribute__((target("avx512f"))) static inline __m512d load8(const dbr_float_t* m_src) {
+    return _mm512_cvtps_pd(_mm256_loadu_ps(m_src));
+}
+__attribute__((target("avx512f"))) static inline __m512d load8(const dbr_long_t* m_src) {
+    return _mm512_cvtepi32_pd(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(m_src)));
+}
+__attribute__((target("avx512f"))) static inline __m512d load8(const dbr_short_t* m_src) {
+    return _mm512_cvtepi32_pd(_mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(m_src))));
+}
+__attribute__((target("avx512f"))) static inline __m512d load8(const dbr_enum_t* m_src) {
+    return _mm512_cvtepi32_pd(_mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(m_src))));
+}
+__attribute__((target("avx512f"))) static inline __m512d load8(const dbr_char_t* m_src) {
+    return _mm512_cvtepi32_pd(_mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(m_src))));
+}
+
+template<typename From, bool Scaled>
+__attribute__((target("avx512f"))) static void avx512_kernel(const From* m_src, double* m_dst, std::size_t m_count, double m_scale, double m_offset) {
+    __m512d scale = _mm512_set1_pd(m_scale);
+    __m512d offset = _mm512_set1_pd(m_offset);
+    std::size_t i = 0;
+    for (; i + 8 <= m_count; i += 8) {
+        __m512d value = load8(m_src + i);
+        if constexpr (Scaled) {
+            value = _mm512_add_pd(_mm512_mul_pd(value, scale), offset);
+        }
+        _mm512_storeu_pd(m_dst + i, value);
+    }
+    scalar_kernel<From, Scaled>(m_src + i, m_dst + i, m_count - i, m_scale, m_offset);
+}
+
+template<typename From>
+__attribute__((target("avx512f"))) static void avx512_reduce(const From* m_src, std::size_t m_count, arrayStats& m_stats) {
+    __m512d low = _mm512_set1_pd(std::numeric_limits<double>::infinity());
+    __m512d high = _mm512_set1_pd(-std::numeric_limits<double>::infinity());
+    __m512d sum = _mm512_setzero_pd();
+    __m512d weighted = _mm512_setzero_pd();
+    __m512d index = _mm512_set_pd(7.0, 6.0, 5.0, 4.0, 3.0, 2.0, 1.0, 0.0);
+    __m512d step = _mm512_set1_pd(8.0);
+    std::size_t i = 0;
+    for (; i + 8 <= m_count; i += 8) {
+        __m512d value = load8(m_src + i);
+        low = _mm512_min_pd(low, value);
+        high = _mm512_max_pd(high, value);
+        sum = _mm512_add_pd(sum, value);
+        weighted = _mm512_add_pd(weighted, _mm512_mul_pd(value, index));
+        index = _mm512_add_pd(index, step);
+    }
+    alignas(64) double lanes[4][8];
+    _mm512_store_pd(lanes[0], low);
+    _mm512_store_pd(lanes[1], high);
+    _mm512_store_pd(lanes[2], sum);
+    _mm512_store_pd(lanes[3], weighted);
+    fold_lanes(lanes[0], lanes[1], lanes[2], lanes[3], 8, m_stats);
+    scalar_reduce(m_src, i, m_count, m_stats);
+}
+#endif
+
+simdLevel caConvert::detected() {
+#ifdef EPICS_PROXY_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return SIMD_AVX512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return SIMD_AVX2;
+    }
+#endif
+    return SIMD_SCALAR;
+}
+
+static std::atomic<simdLevel> activeLevel{caConvert::detected()};
+
+simdLevel caConvert::get_level() {
+    return activeLevel.load(std::memory_order_relaxed);
+}
+
+void caConvert::set_level(simdLevel m_level) {
+    activeLevel = m_level < detected() ? m_level : detected();
+}
+
+const char* caConvert::level_name(simdLevel m_level) {
+    if (m_level == SIMD_AVX512) {
+        return "avx512";
+    } else if (m_level == SIMD_AVX2) {
+        return "avx2";
+    }
+    return "scalar";
+}
+
+//Unscaled conversions skip the multiply and add, which also keeps -0.0 intact
+template<typename From>
+static void dispatch(const From* m_src, double* m_dst, std::size_t m_count, double m_scale, double m_offset) {
+    bool scaled = m_scale != 1.0 || m_offset != 0.0;
+#ifdef EPICS_PROXY_SIMD_X86
+    simdLevel level = activeLevel.load(std::memory_order_relaxed);
+    if (level == SIMD_AVX512) {
+        scaled ? avx512_kernel<From, true>(m_src, m_dst, m_count, m_scale, m_offset)
+               : avx512_kernel<From, false>(m_src, m_dst, m_count, m_scale, m_offset);
+        return;
+    }
+    if (level == SIMD_AVX2) {
+        scaled ? avx2_kernel<From, true>(m_src, m_dst, m_count, m_scale, m_offset)
+               : avx2_kernel<From, false>(m_src, m_dst, m_count, m_scale, m_offset);
+        return;
+    }
+#endif
+    scaled ? scalar_kernel<From, true>(m_src, m_dst, m_count, m_scale, m_offset)
+           : scalar_kernel<From, false>(m_src, m_dst, m_count, m_scale, m_offset);
+}
+
+template<typename From>
+static arrayStats reduce_dispatch(const void* m_src, std::size_t m_count) {
+    const From* m_in = static_cast<const From*>(m_src);
+    arrayStats stats;
+    stats.count = static_cast<unsigned long>(m_count);
+    stats.min = std::numeric_limits<double>::infinity();
+    stats.max = -std::numeric_limits<double>::infinity();
+#ifdef EPICS_PROXY_SIMD_X86
+    simdLevel level = activeLevel.load(std::memory_order_relaxed);
+    if (level == SIMD_AVX512) {
+        avx512_reduce(m_in, m_count, stats);
+    } else if (level == SIMD_AVX2) {
+        avx2_reduce(m_in, m_count, stats);
+    } else {
+        scalar_reduce(m_in, 0, m_count, stats);
+    }
+#else
+    scalar_reduce(m_in, 0, m_count, stats);
+#endif
+    if (m_count == 0) {
+        stats.min = 0.0;
+        stats.max = 0.0;
+    }
+    return stats;
+}
+
+void caConvert::to_double(const dbr_double_t* m_src, double* m_dst, std::size_t m_count, double m_scale, double m_offset) {
+    dispatch(m_src, m_dst, m_count, m_scale, m_offset);
+}
+
+void caConvert::to_double(const dbr_float_t* m_src, double* m_dst, std::size_t m_count, double m_scale, double m_offset) {
+    dispatch(m_src, m_dst, m_count, m_scale, m_offset);
+}
+
+void caConvert::to_double(const dbr_long_t* m_src, double* m_dst, std::size_t m_count, double m_scale, double m_offset) {
+    dispatch(m_src, m_dst, m_count, m_scale, m_offset);
+}
+
+void caConvert::to_double(const dbr_short_t* m_src, double* m_dst, std::size_t m_count, double m_scale, double m_offset) {
+    dispatch(m_src, m_dst, m_count, m_scale, m_offset);
+}
+
+void caConvert::to_double(const dbr_enum_t* m_src, double* m_dst, std::size_t m_count, double m_scale, double m_offset) {
+    dispatch(m_src, m_dst, m_count, m_scale, m_offset);
+}
+
+void caConvert::to_double(const dbr_char_t* m_src, double* m_dst, std::size_t m_count, double m_scale, double m_offset) {
+    dispatch(m_src, m_dst, m_count, m_scale, m_offset);
+}
+
+void caConvert::to_double(const void* m_src, chtype m_type, double* m_dst, std::size_t m_count, double m_scale, double m_offset) {
+    if (m_type == DBR_DOUBLE) {
+        to_double(static_cast<const dbr_double_t*>(m_src), m_dst, m_count, m_scale, m_offset);
+    } else if (m_type == DBR_FLOAT) {
+        to_double(static_cast<const dbr_float_t*>(m_src), m_dst, m_count, m_scale, m_offset);
+    } else if (m_type == DBR_LONG) {
+        to_double(static_cast<const dbr_long_t*>(m_src), m_dst, m_count, m_scale, m_offset);
+    } else if (m_type == DBR_SHORT) {
+        to_double(static_cast<const dbr_short_t*>(m_src), m_dst, m_count, m_scale, m_offset);
+    } else if (m_type == DBR_ENUM) {
+        to_double(static_cast<const dbr_enum_t*>(m_src), m_dst, m_count, m_scale, m_offset);
+    } else if (m_type == DBR_CHAR) {
+        to_double(static_cast<const dbr_char_t*>(m_src), m_dst, m_count, m_scale, m_offset);
+    } else {
+        throw std::runtime_error("Cannot convert CA type " + std::to_string(m_type) + " to double");
+    }
+}
+
+arrayStats caConvert::reduce(const void* m_src, chtype m_type, std::size_t m_count) {
+    if (m_type == DBR_DOUBLE) {
+        return reduce_dispatch<dbr_double_t>(m_src, m_count);
+    } else if (m_type == DBR_FLOAT) {
+        return reduce_dispatch<dbr_float_t>(m_src, m_count);
+    } else if (m_type == DBR_LONG) {
+        return reduce_dispatch<dbr_long_t>(m_src, m_count);
+    } else if (m_type == DBR_SHORT) {
+        return reduce_dispatch<dbr_short_t>(m_src, m_count);
+    } else if (m_type == DBR_ENUM) {
+        return reduce_dispatch<dbr_enum_t>(m_src, m_count);
+    } else if (m_type == DBR_CHAR) {
+        return reduce_dispatch<dbr_char_t>(m_src, m_count);
+    }
+    throw std::runtime_error("Cannot reduce CA type " + std::to_string(m_type));
+}
+} // namespace epics
@@ -0,0 +1,98 @@
+/**
+ * @file caImage.cpp
+ * @brief areaDetector image access with cached shape and in-place frame views.
+ */
+
+#include "caImage.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace epics {
+
+caImage::caImage(std::string m_pluginName, std::array<PV*, SHAPE_FIELDS + 1> m_pvs) {
+    pluginName = m_pluginName;
+    state = std::make_unique<imageState>();
+    try {
+        for (int i = 0; i < SHAPE_FIELDS; i++) {
+            shapeHook& hook = state->shape[i];
+            hook.pv = m_pvs[i];
+            //DBR_LONG also turns the DataType_RBV enum into its index
+            hook.subscription = caChannelTable::instance().subscribe(hook.pv->get_shared_channel(), DBR_LONG, 1, DBE_VALUE,
+                                                                     shape_callback, &hook);
+        }
+        //Dynamic size, so each frame holds the image's NORD elements rather than the whole NELM
+        state->arrayData = m_pvs[SHAPE_FIELDS];
+        state->arrayData->set_dynamic_size(true);
+        state->frames = state->arrayData->add_array_monitor();
+    } catch (...) {
+        //The destructor does not run for a constructor that throws
+        for (shapeHook& hook : state->shape) {
+            if (hook.subscription != nullptr) {
+                caChannelTable::instance().unsubscribe(hook.subscription, &hook);
+            }
+        }
+        throw;
+    }
+    //The first event of each subscription carries the current shape
+    SEVCHK(get_transport()->flush_io(), ("Failed to monitor image " + pluginName).c_str());
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    for (shapeHook& hook : state->shape) {
+        while (!hook.received && std::chrono::steady_clock::now() < deadline) {
+            get_transport()->pend_event(0.001);
+        }
+        if (!hook.received) {
+            SEVCHK(ECA_TIMEOUT, ("Failed to read shape of image " + pluginName).c_str());
+        }
+    }
+}
+
+caImage::~caImage() {
+    if (state == nullptr) {
+        return;
+    }
+    for (shapeHook& hook : state->shape) {
+        caChannelTable::instance().unsubscribe(hook.subscription, &hook);
+    }
+    //Also deletes the frame buffer
+    state->arrayData->remove_monitor();
+}
+
+void caImage::shape_callback(struct event_handler_args args) {
+    shapeHook* hook = static_cast<shapeHook*>(args.usr);
+    if (args.status != ECA_NORMAL || args.dbr == nullptr) {
+        return;
+    }
+    hook->value.store(*static_cast<const dbr_long_t*>(args.dbr), std::memory_order_relaxed);
+    hook->received.store(true, std::memory_order_release);
+}
+
+std::size_t caImage::get_ndims() {
+    long ndims = state->shape[NDIMENSIONS].value.load(std::memory_order_relaxed);
+    return static_cast<std::size_t>(std::clamp(ndims, 0L, 3L));
+}
+
+//Dimensions beyond NDimensions count as 1, so a 2D image is {x, y, 1}
+std::array<std::size_t, 3> caImage::get_dims() {
+    std::size_t ndims = get_ndims();
+    std::array<std::size_t, 3> dims = {1, 1, 1};
+    for (std::size_t i = 0; i < ndims; i++) {
+        long size = state->shape[SIZE0 + i].value.load(std::memory_order_relaxed);
+        dims[i] = static_cast<std::size_t>(std::max(size, 0L));
+    }
+    return dims;
+}
+
+ndDataType caImage::get_data_type() {
+    return static_cast<ndDataType>(state->shape[DATATYPE].value.load(std::memory_order_relaxed));
+}
+
+imageFrame caImage::latest() {
+    imageFrame image;
+    image.frame = state->frames->latest();
+    image.dims = get_dims();
+    image.ndims = get_ndims();
+    image.dataType = get_data_type();
+    return image;
+}
+} // namespace epics
@@ -0,0 +1,122 @@
+/**
+ * @file caLatency.cpp
+ * @brief Implementation of the per-PV latency histograms.
+ */
+
+#include "caLatency.h"
+
+#include <algorithm>
+
+namespace epics {
+
+int latencyHistogram::bucket_index(uint64_t ns) {
+    if (ns < static_cast<uint64_t>(subBuckets)) {
+        return static_cast<int>(ns);
+    }
+    int msb = 63 - __builtin_clzll(ns);
+    int shift = msb - subBucketBits;
+    if (shift >= maxShift) {
+        return bucketCount - 1;
+    }
+    int mantissa = static_cast<int>(ns >> shift) - subBuckets;
+    return (shift + 1) * subBuckets + mantissa;
+}
+
+uint64_t latencyHistogram::bucket_upper(int index) {
+    if (index < subBuckets) {
+        return static_cast<uint64_t>(index);
+    }
+    int shift = index / subBuckets - 1;
+    uint64_t mantissa = static_cast<uint64_t>(subBuckets + index % subBuckets);
+    return ((mantissa + 1) << shift) - 1;
+}
+
+void latencyHistogram::record(uint64_t ns) {
+    buckets[bucket_index(ns)].fetch_add(1, std::memory_order_relaxed);
+    count.fetch_add(1, std::memory_order_relaxed);
+    sum.fetch_add(ns, std::memory_order_relaxed);
+    uint64_t seen = min.load(std::memory_order_relaxed);
+    while (ns < seen && !min.compare_exchange_weak(seen, ns, std::memory_order_relaxed)) {
+    }
+    seen = max.load(std::memory_order_relaxed);
+    while (ns > seen && !max.compare_exchange_weak(seen, ns, std::memory_order_relaxed)) {
+    }
+}
+
+//Buckets are read one by one while writers continue, so a snapshot taken under load
+//may be off by the few events recorded during the copy
+latencySnapshot latencyHistogram::snapshot() {
+    latencySnapshot snap;
+    std::vector<uint64_t> counts(bucketCount);
+    uint64_t total = 0;
+    for (int i = 0; i < bucketCount; i++) {
+        counts[i] = buckets[i].load(std::memory_order_relaxed);
+        total += counts[i];
+        if (counts[i] != 0) {
+            snap.buckets.push_back({bucket_upper(i), counts[i]});
+        }
+    }
+    if (total == 0) {
+        return snap;
+    }
+    snap.count = total;
+    snap.min_ns = min.load(std::memory_order_relaxed);
+    snap.max_ns = max.load(std::memory_order_relaxed);
+    snap.mean_ns = static_cast<double>(sum.load(std::memory_order_relaxed)) / count.load(std::memory_order_relaxed);
+
+    uint64_t* targets[] = {&snap.p50_ns, &snap.p90_ns, &snap.p99_ns, &snap.p999_ns};
+    double fractions[] = {0.50, 0.90, 0.99, 0.999};
+    uint64_t seen = 0;
+    int next = 0;
+    for (int i = 0; i < bucketCount && next < 4; i++) {
+        seen += counts[i];
+        while (next < 4 && seen >= static_cast<uint64_t>(fractions[next] * total + 0.5)) {
+            //Clamp to the observed extremes so coarse buckets do not overstate them
+            *targets[next] = std::min(std::max(bucket_upper(i), snap.min_ns), snap.max_ns);
+            next++;
+        }
+    }
+    return snap;
+}
+
+caLatencyStats::~caLatencyStats() {
+    for (auto& histogram : histograms) {
+        delete histogram.load();
+    }
+}
+
+void caLatencyStats::record_duration(latencyOp op, uint64_t ns) {
+#ifndef EPICS_PROXY_NO_LATENCY
+    latencyHistogram* histogram = histograms[op].load(std::memory_order_acquire);
+    if (histogram == nullptr) {
+        //First use: install a histogram, or use the one another thread installed first
+        latencyHistogram* created = new latencyHistogram();
+        if (histograms[op].compare_exchange_strong(histogram, created, std::memory_order_acq_rel)) {
+            histogram = created;
+        } else {
+            delete created;
+        }
+    }
+    histogram->record(ns);
+#else
+    (void)op;
+    (void)ns;
+#endif
+}
+
+latencySnapshot caLatencyStats::snapshot(latencyOp op) {
+    latencyHistogram* histogram = histograms[op].load(std::memory_order_acquire);
+    return histogram != nullptr ? histogram->snapshot() : latencySnapshot();
+}
+
+const char* latency_op_name(latencyOp op) {
+    switch (op) {
+        case LATENCY_GET: return "get";
+        case LATENCY_PUT: return "put";
+        case LATENCY_PUT_CALLBACK: return "put_callback";
+        case LATENCY_CONNECT: return "connect";
+        case LATENCY_MONITOR_INTERVAL: return "monitor_interval";
+        default: return "unknown";
+    }
+}
+} // namespace epics
@@ -0,0 +1,110 @@
+/**
+ * @file caManifest.cpp
+ * @brief Reading and interning PV manifest files.
+ */
+
+#include "caManifest.h"
+
+#include <cstdio>
+#include <stdexcept>
+#include <unordered_set>
+
+namespace epics {
+
+caManifest::caManifest(std::string m_path) {
+    std::FILE* file = std::fopen(m_path.c_str(), "rb");
+    if (file == nullptr) {
+        throw std::runtime_error("Failed to open manifest " + m_path);
+    }
+    std::fseek(file, 0, SEEK_END);
+    long size = std::ftell(file);
+    std::fseek(file, 0, SEEK_SET);
+    text.resize(size > 0 ? static_cast<std::size_t>(size) : 0);
+    std::size_t read = text.empty() ? 0 : std::fread(text.data(), 1, text.size(), file);
+    std::fclose(file);
+    if (read != text.size()) {
+        throw std::runtime_error("Failed to read manifest " + m_path);
+    }
+    _parse(m_path);
+}
+
+chtype caManifest::type_from_name(std::string_view m_name) {
+    static const struct {const char* name; chtype type;} types[] = {
+        {"double", DBR_DOUBLE}, {"float", DBR_FLOAT}, {"enum", DBR_ENUM}, {"short", DBR_SHORT},
+        {"char", DBR_CHAR}, {"string", DBR_STRING}, {"long", DBR_LONG}, {"-", TYPENOTCONN}
+    };
+    for (const auto& entry : types) {
+        if (m_name == entry.name) {
+            return entry.type;
+        }
+    }
+    throw std::runtime_error("Type " + std::string(m_name) + " not supported");
+}
+
+//Splits each line into fields in place; names stay in text, so text must not change afterwards
+void caManifest::_parse(std::string m_path) {
+    std::unordered_set<std::string_view> seen;
+    std::size_t position = 0;
+    std::size_t line = 0;
+    while (position < text.size()) {
+        std::size_t end = text.find('\n', position);
+        if (end == std::string::npos) {
+            end = text.size();
+        }
+        std::string_view content(text.data() + position, end - position);
+        position = end + 1;
+        line++;
+        std::size_t comment = content.find('#');
+        if (comment != std::string_view::npos) {
+            content = content.substr(0, comment);
+        }
+
+        std::string_view fields[3];
+        int count = 0;
+        std::size_t i = 0;
+        while (i < content.size()) {
+            while (i < content.size() && (content[i] == ' ' || content[i] == '\t' || content[i] == '\r')) {
+                i++;
+            }
+            std::size_t start = i;
+            while (i < content.size() && content[i] != ' ' && content[i] != '\t' && content[i] != '\r') {
+                i++;
+            }
+            if (i == start) {
+                break;
+            }
+            if (count == 3) {
+                throw std::runtime_error("Manifest " + m_path + " line " + std::to_string(line) + ": too many fields");
+            }
+            fields[count++] = content.substr(start, i - start);
+        }
+        if (count == 0) {
+            continue;
+        }
+
+        manifestEntry entry;
+        entry.name = fields[0];
+        if (count > 1) {
+            entry.type = type_from_name(fields[1]);
+        }
+        if (count > 2) {
+            unsigned long priority = 0;
+            for (char c : fields[2]) {
+                if (c < '0' || c > '9') {
+                    throw std::runtime_error("Manifest " + m_path + " line " + std::to_string(line) + ": bad priority");
+                }
+                priority = priority * 10 + static_cast<unsigned long>(c - '0');
+            }
+            if (priority > CA_PRIORITY_MAX) {
+                throw std::runtime_error("Manifest " + m_path + " line " + std::to_string(line) + ": priority above 99");
+            }
+            entry.priority = static_cast<unsigned>(priority);
+        }
+        if (!seen.insert(entry.name).second) {
+            duplicates++;
+            continue;
+        }
+        entries.push_back(entry);
+    }
+}
+} // namespace epics
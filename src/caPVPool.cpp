@@ -0,0 +1,34 @@
+/**
+ * @file caPVPool.cpp
+ * @brief Implementation of the PV slab used by bulk loads.
+ */
+
+#include "caPVPool.h"
+
+#include <new>
+#include <stdexcept>
+
+namespace epics {
+
+caPVPool::caPVPool(std::size_t m_capacity) {
+    capacity = m_capacity;
+    slots = static_cast<PV*>(::operator new(capacity * sizeof(PV), std::align_val_t(alignof(PV))));
+}
+
+caPVPool::~caPVPool() {
+    while (size > 0) {
+        slots[--size].~PV();
+    }
+    ::operator delete(slots, std::align_val_t(alignof(PV)));
+}
+
+PV* caPVPool::create(std::string m_deviceName, std::string m_fieldName, unsigned m_priority, bool m_lazy) {
+    if (size == capacity) {
+        throw std::runtime_error("PV pool is full");
+    }
+    //size only grows once the constructor has succeeded
+    PV* m_pv = new (slots + size) PV(m_deviceName, m_fieldName, m_priority, m_lazy);
+    size++;
+    return m_pv;
+}
+} // namespace epics
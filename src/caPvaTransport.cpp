@@ -0,0 +1,729 @@
+/**
+ * @file caPvaTransport.cpp
+ * @brief pvAccess implementation of the transport interface (EPICS 7, make PVA=1).
+ */
+
+#include "caPvaTransport.h"
+
+#ifdef EPICS_PROXY_WITH_PVA
+
+#include <chrono>
+#include <thread>
+#include <cstring>
+#include <cstdlib>
+#include <sstream>
+#include <algorithm>
+
+#include <pv/createRequest.h>
+#include <pv/sharedVector.h>
+
+namespace epics {
+
+namespace pvd = ::epics::pvData;
+
+//Seconds from the POSIX epoch (pvAccess time stamps) to the EPICS epoch (CA time stamps)
+static const int64_t posixTimeAtEpicsEpoch = 631152000;
+
+/*
+A channel and its connection state. The first get after each connect learns the native
+type and element count; only then is the user's connection handler told the channel is up.
+*/
+struct caPvaTransport::pvaChannel : public pvac::ClientChannel::ConnectCallback, public pvac::ClientChannel::GetCallback {
+    caPvaTransport* owner;
+    uint64_t id;
+    std::string name;
+    pvac::ClientChannel channel;
+    pvac::Operation probe;
+    caCh* conn_callback = nullptr;
+    void* puser = nullptr;
+    bool connected = false;
+    bool everConnected = false;
+    chtype type = DBR_DOUBLE;
+    unsigned long count = 0;
+
+    void connectEvent(const pvac::ConnectEvent& evt) override {
+        if (evt.connected) {
+            pvac::Operation m_probe = channel.get(this, pvd::createRequest("field(value)"));
+            std::lock_guard<std::mutex> lock(owner->mutex);
+            probe = m_probe;
+            return;
+        }
+        caCh* callback;
+        {
+            std::lock_guard<std::mutex> lock(owner->mutex);
+            if (!connected) {
+                return;
+            }
+            connected = false;
+            callback = conn_callback;
+        }
+        if (callback != nullptr) {
+            struct connection_handler_args args;
+            args.chid = reinterpret_cast<chid>(this);
+            args.op = CA_OP_CONN_DOWN;
+            callback(args);
+        }
+    }
+
+    void getDone(const pvac::GetEvent& evt) override {
+        caCh* callback;
+        {
+            std::lock_guard<std::mutex> lock(owner->mutex);
+            if (evt.event == pvac::GetEvent::Success) {
+                type = native_type(*evt.value, &count);
+            } else if (evt.event == pvac::GetEvent::Cancel) {
+                return;
+            }
+            connected = true;
+            everConnected = true;
+            callback = conn_callback;
+        }
+        if (callback != nullptr) {
+            struct connection_handler_args args;
+            args.chid = reinterpret_cast<chid>(this);
+            args.op = CA_OP_CONN_UP;
+            callback(args);
+        }
+    }
+};
+
+/*
+One get or put. Blocking operations (no user callback) write straight into the caller's
+buffer and are waited for by pend_io. Finished operations are freed by _reap() from a
+user thread, never from inside their own pvAccess callback.
+*/
+struct caPvaTransport::pvaOperation : public pvac::ClientChannel::GetCallback, public pvac::ClientChannel::PutCallback {
+    caPvaTransport* owner;
+    uint64_t id;
+    chid channel;
+    chtype type;
+    unsigned long count;
+    void* value = nullptr;              //Destination of a blocking get
+    std::vector<char> data;             //Copy of the value of a put
+    caEventCallBackFunc* callback = nullptr;
+    void* usr = nullptr;
+    pvac::Operation operation;
+    bool started = false;
+    bool finished = false;
+
+    void getDone(const pvac::GetEvent& evt) override {
+        if (evt.event == pvac::GetEvent::Cancel) {
+            return;
+        }
+        bool failed = evt.event != pvac::GetEvent::Success;
+        if (callback == nullptr) {
+            int status = failed ? ECA_GETFAIL : encode(*evt.value, type, count, value);
+            owner->_finished(this, true, status != ECA_NORMAL);
+            return;
+        }
+        std::vector<char> buffer(dbr_size_n(type, count));
+        struct event_handler_args args;
+        args.usr = usr;
+        args.chid = channel;
+        args.type = type;
+        args.count = static_cast<long>(count);
+        args.status = failed ? ECA_GETFAIL : encode(*evt.value, type, count, buffer.data());
+        args.dbr = args.status == ECA_NORMAL ? buffer.data() : nullptr;
+        callback(args);
+        owner->_finished(this, false, false);
+    }
+
+    void putBuild(const pvd::StructureConstPtr& build, pvac::ClientChannel::PutCallback::Args& args) override {
+        args.root = pvd::getPVDataCreate()->createPVStructure(build);
+        pvd::PVFieldPtr field = args.root->getSubField("value");
+        const char* in = data.data();
+        if (pvd::PVScalarPtr scalar = std::dynamic_pointer_cast<pvd::PVScalar>(field)) {
+            if (type == DBR_STRING) {
+                scalar->putFrom<std::string>(std::string(in));
+            } else {
+                scalar->putFrom<double>(_element(in, 0));
+            }
+        } else if (pvd::PVScalarArrayPtr array = std::dynamic_pointer_cast<pvd::PVScalarArray>(field)) {
+            if (type == DBR_STRING) {
+                pvd::shared_vector<std::string> strings(count);
+                for (unsigned long i = 0; i < count; i++) {
+                    strings[i] = std::string(in + i * sizeof(dbr_string_t));
+                }
+                array->putFrom<std::string>(pvd::freeze(strings));
+            } else {
+                pvd::shared_vector<double> numbers(count);
+                for (unsigned long i = 0; i < count; i++) {
+                    numbers[i] = _element(in, i);
+                }
+                array->putFrom<double>(pvd::freeze(numbers));
+            }
+        } else if (pvd::PVIntPtr index = args.root->getSubField<pvd::PVInt>("value.index")) {
+            //NTEnum: a number is the index, a string is looked up in value.choices
+            index->put(type == DBR_STRING ? _choice(args.previous, std::string(in)) : static_cast<int32_t>(_element(in, 0)));
+            field = index;
+        } else {
+            throw std::runtime_error("PV " + std::string(owner->name(channel)) + " has an unsupported value field");
+        }
+        args.tosend.set(field->getFieldOffset());
+    }
+
+    void putDone(const pvac::PutEvent& evt) override {
+        if (evt.event == pvac::PutEvent::Cancel) {
+            return;
+        }
+        int status = evt.event == pvac::PutEvent::Success ? ECA_NORMAL : ECA_PUTFAIL;
+        if (callback != nullptr) {
+            struct event_handler_args args;
+            args.usr = usr;
+            args.chid = channel;
+            args.type = type;
+            args.count = static_cast<long>(count);
+            args.status = status;
+            args.dbr = nullptr;
+            callback(args);
+            owner->_finished(this, false, false);
+            return;
+        }
+        caExceptionHandler* handler;
+        void* handlerUsr;
+        {
+            std::lock_guard<std::mutex> lock(owner->mutex);
+            handler = owner->exceptionHandler;
+            handlerUsr = owner->exceptionUsr;
+        }
+        //Like CA, a rejected put without callback is reported through the exception handler
+        if (status != ECA_NORMAL && handler != nullptr) {
+            struct exception_handler_args args = {};
+            args.usr = handlerUsr;
+            args.chid = channel;
+            args.type = type;
+            args.count = static_cast<long>(count);
+            args.stat = status;
+            args.ctx = evt.message.c_str();
+            handler(args);
+        }
+        owner->_finished(this, true, status != ECA_NORMAL);
+    }
+
+    //Index of an enum state given by name. String puts fetch the previous value, which
+    //carries the choices. Like CA, a string that names no state may give the index.
+    int32_t _choice(const pvd::PVStructure::const_shared_pointer& previous, const std::string& m_state) {
+        if (previous) {
+            if (pvd::PVStringArray::const_shared_pointer choices = previous->getSubField<pvd::PVStringArray>("value.choices")) {
+                pvd::PVStringArray::const_svector states = choices->view();
+                for (std::size_t i = 0; i < states.size(); i++) {
+                    if (states[i] == m_state) {
+                        return static_cast<int32_t>(i);
+                    }
+                }
+            }
+        }
+        char* end = nullptr;
+        long m_index = std::strtol(m_state.c_str(), &end, 10);
+        if (m_state.empty() || *end != '\0') {
+            throw std::runtime_error("PV " + std::string(owner->name(channel)) + " has no state \"" + m_state + "\"");
+        }
+        return static_cast<int32_t>(m_index);
+    }
+
+    //Element i of a plain DBR buffer as a double
+    double _element(const char* in, unsigned long i) {
+        switch (type) {
+            case DBR_SHORT: return reinterpret_cast<const dbr_short_t*>(in)[i];
+            case DBR_FLOAT: return reinterpret_cast<const dbr_float_t*>(in)[i];
+            case DBR_ENUM: return reinterpret_cast<const dbr_enum_t*>(in)[i];
+            case DBR_CHAR: return reinterpret_cast<const dbr_char_t*>(in)[i];
+            case DBR_LONG: return reinterpret_cast<const dbr_long_t*>(in)[i];
+            case DBR_DOUBLE: return reinterpret_cast<const dbr_double_t*>(in)[i];
+            default: return 0.0;
+        }
+    }
+};
+
+struct caPvaTransport::pvaSubscription : public pvac::ClientChannel::MonitorCallback {
+    caPvaTransport* owner;
+    uint64_t id;
+    chid channel;
+    chtype type;
+    unsigned long count;
+    caEventCallBackFunc* callback;
+    void* usr;
+    pvac::Monitor monitor;
+
+    void monitorEvent(const pvac::MonitorEvent& evt) override {
+        if (evt.event != pvac::MonitorEvent::Data) {
+            return;
+        }
+        std::vector<char> buffer;
+        while (monitor.poll()) {
+            unsigned long m_count = count;
+            if (m_count == 0) {
+                native_type(*monitor.root, &m_count);
+            }
+            buffer.resize(dbr_size_n(type, m_count));
+            struct event_handler_args args;
+            args.usr = usr;
+            args.chid = channel;
+            args.type = type;
+            args.count = static_cast<long>(m_count);
+            args.status = encode(*monitor.root, type, m_count, buffer.data());
+            args.dbr = args.status == ECA_NORMAL ? buffer.data() : nullptr;
+            callback(args);
+        }
+    }
+};
+
+caPvaTransport::caPvaTransport(pvaConfig m_config) {
+    config = m_config;
+}
+
+caPvaTransport::~caPvaTransport() {
+    if (contexts > 0) {
+        contexts = 1;
+        context_destroy();
+    }
+}
+
+//Fields a get, put or monitor of the given DBR type needs
+std::string caPvaTransport::request_for(chtype type) {
+    if (type >= DBR_TIME_STRING && type <= DBR_TIME_DOUBLE) {
+        return "field(value,timeStamp,alarm)";
+    }
+    return "field(value)";
+}
+
+chtype caPvaTransport::native_type(const pvd::PVStructure& root, unsigned long* count) {
+    pvd::PVField::const_shared_pointer field = root.getSubField("value");
+    *count = 1;
+    pvd::ScalarType scalarType;
+    if (pvd::PVScalar::const_shared_pointer scalar = std::dynamic_pointer_cast<const pvd::PVScalar>(field)) {
+        scalarType = scalar->getScalar()->getScalarType();
+    } else if (pvd::PVScalarArray::const_shared_pointer array = std::dynamic_pointer_cast<const pvd::PVScalarArray>(field)) {
+        scalarType = array->getScalarArray()->getElementType();
+        *count = array->getLength();
+    } else {
+        //NTEnum (value.index and value.choices) or an unknown structure
+        return DBR_ENUM;
+    }
+    switch (scalarType) {
+        case pvd::pvBoolean:
+        case pvd::pvByte:
+        case pvd::pvUByte: return DBR_CHAR;
+        case pvd::pvShort:
+        case pvd::pvUShort: return DBR_SHORT;
+        case pvd::pvInt:
+        case pvd::pvUInt: return DBR_LONG;
+        case pvd::pvFloat: return DBR_FLOAT;
+        case pvd::pvString: return DBR_STRING;
+        default: return DBR_DOUBLE;
+    }
+}
+
+//Convert the value (and for DBR_TIME types the time stamp and alarm) of a structure into a DBR buffer
+int caPvaTransport::encode(const pvd::PVStructure& root, chtype type, unsigned long count, void* value) {
+    chtype plain = type;
+    char* out = static_cast<char*>(value);
+    if (type >= DBR_TIME_STRING && type <= DBR_TIME_DOUBLE) {
+        //All DBR_TIME_ structures start with status, severity and stamp
+        struct dbr_time_double* header = static_cast<struct dbr_time_double*>(value);
+        pvd::PVLong::const_shared_pointer seconds = root.getSubField<pvd::PVLong>("timeStamp.secondsPastEpoch");
+        pvd::PVInt::const_shared_pointer nanoseconds = root.getSubField<pvd::PVInt>("timeStamp.nanoseconds");
+        pvd::PVInt::const_shared_pointer severity = root.getSubField<pvd::PVInt>("alarm.severity");
+        header->status = 0;
+        header->severity = severity ? static_cast<dbr_short_t>(severity->get()) : 0;
+        header->stamp.secPastEpoch = seconds ? static_cast<uint32_t>(std::max<int64_t>(seconds->get() - posixTimeAtEpicsEpoch, 0)) : 0;
+        header->stamp.nsec = nanoseconds ? static_cast<uint32_t>(nanoseconds->get()) : 0;
+        plain = static_cast<chtype>(type - DBR_TIME_STRING);
+        out = static_cast<char*>(dbr_value_ptr(value, type));
+    } else if (type < DBR_STRING || type > DBR_DOUBLE) {
+        return ECA_BADTYPE;
+    }
+
+    pvd::PVField::const_shared_pointer field = root.getSubField("value");
+    pvd::shared_vector<const double> numbers;
+    pvd::shared_vector<const std::string> strings;
+    if (pvd::PVScalar::const_shared_pointer scalar = std::dynamic_pointer_cast<const pvd::PVScalar>(field)) {
+        if (plain == DBR_STRING) {
+            pvd::shared_vector<std::string> one(1, scalar->getAs<std::string>());
+            strings = pvd::freeze(one);
+        } else {
+            pvd::shared_vector<double> one(1, scalar->getAs<double>());
+            numbers = pvd::freeze(one);
+        }
+    } else if (pvd::PVScalarArray::const_shared_pointer array = std::dynamic_pointer_cast<const pvd::PVScalarArray>(field)) {
+        if (plain == DBR_STRING) {
+            array->getAs<std::string>(strings);
+        } else {
+            array->getAs<double>(numbers);
+        }
+    } else if (pvd::PVInt::const_shared_pointer index = root.getSubField<pvd::PVInt>("value.index")) {
+        pvd::PVStringArray::const_shared_pointer choices = root.getSubField<pvd::PVStringArray>("value.choices");
+        int32_t m_index = index->get();
+        if (plain == DBR_STRING) {
+            pvd::shared_vector<std::string> one(1, std::to_string(m_index));
+            if (choices && m_index >= 0 && static_cast<std::size_t>(m_index) < choices->view().size()) {
+                one[0] = choices->view()[m_index];
+            }
+            strings = pvd::freeze(one);
+        } else {
+            pvd::shared_vector<double> one(1, static_cast<double>(m_index));
+            numbers = pvd::freeze(one);
+        }
+    } else {
+        return ECA_BADTYPE;
+    }
+
+    for (unsigned long i = 0; i < count; i++) {
+        double v = i < numbers.size() ? numbers[i] : 0.0;
+        switch (plain) {
+            case DBR_STRING: {
+                char* slot = out + i * sizeof(dbr_string_t);
+                std::memset(slot, 0, sizeof(dbr_string_t));
+                if (i < strings.size()) {
+                    std::strncpy(slot, strings[i].c_str(), sizeof(dbr_string_t) - 1);
+                }
+                break;
+            }
+            case DBR_SHORT: reinterpret_cast<dbr_short_t*>(out)[i] = static_cast<dbr_short_t>(v); break;
+            case DBR_FLOAT: reinterpret_cast<dbr_float_t*>(out)[i] = static_cast<dbr_float_t>(v); break;
+            case DBR_ENUM: reinterpret_cast<dbr_enum_t*>(out)[i] = static_cast<dbr_enum_t>(v); break;
+            case DBR_CHAR: reinterpret_cast<dbr_char_t*>(out)[i] = static_cast<dbr_char_t>(v); break;
+            case DBR_LONG: reinterpret_cast<dbr_long_t*>(out)[i] = static_cast<dbr_long_t>(v); break;
+            case DBR_DOUBLE: reinterpret_cast<dbr_double_t*>(out)[i] = v; break;
+        }
+    }
+    return ECA_NORMAL;
+}
+
+caPvaTransport::pvaChannel* caPvaTransport::_channel(chid channel) {
+    return reinterpret_cast<pvaChannel*>(channel);
+}
+
+//Called from a pvAccess thread when an operation completes
+void caPvaTransport::_finished(pvaOperation* operation, bool blocking, bool failed) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        operation->finished = true;
+        if (blocking && outstanding > 0) {
+            outstanding--;
+            pendingFailure = pendingFailure || failed;
+        }
+    }
+    done.notify_all();
+}
+
+//Free finished operations; caller must hold the mutex
+void caPvaTransport::_reap() {
+    for (auto it = operations.begin(); it != operations.end();) {
+        if (it->second->started && it->second->finished) {
+            it = operations.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+//Cancel operations without holding the mutex, since cancel waits for running callbacks
+void caPvaTransport::_cancel(std::vector<pvaOperation*> m_operations) {
+    for (pvaOperation* operation : m_operations) {
+        operation->operation.cancel();
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    for (pvaOperation* operation : m_operations) {
+        operations.erase(operation->id);
+    }
+}
+
+int caPvaTransport::context_create(enum ca_preemptive_callback_select) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (contexts++ == 0) {
+        provider = pvac::ClientProvider(config.provider);
+    }
+    return ECA_NORMAL;
+}
+
+void caPvaTransport::context_destroy() {
+    std::vector<pvaOperation*> m_operations;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (contexts == 0 || --contexts > 0) {
+            return;
+        }
+        for (auto& entry : operations) {
+            m_operations.push_back(entry.second.get());
+        }
+    }
+    _cancel(m_operations);
+    for (auto& entry : subscriptions) {
+        entry.second->monitor.cancel();
+    }
+    for (auto& entry : channels) {
+        entry.second->probe.cancel();
+        entry.second->channel.removeConnectListener(entry.second.get());
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    subscriptions.clear();
+    channels.clear();
+    outstanding = 0;
+    provider.disconnect();
+}
+
+struct ca_client_context* caPvaTransport::current_context() {
+    return nullptr;
+}
+
+//The pvAccess provider is shared by all threads
+int caPvaTransport::attach_context(struct ca_client_context*) {
+    return ECA_NORMAL;
+}
+
+void caPvaTransport::detach_context() {
+}
+
+int caPvaTransport::create_channel(const char* name, caCh* conn_callback, void* puser, unsigned priority, chid* channel) {
+    pvaChannel* ch;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::unique_ptr<pvaChannel> m_channel = std::make_unique<pvaChannel>();
+        ch = m_channel.get();
+        ch->owner = this;
+        ch->id = nextId++;
+        ch->name = name;
+        ch->conn_callback = conn_callback;
+        ch->puser = puser;
+        pvac::ClientChannel::Options options;
+        options.priority = static_cast<short>(priority);
+        ch->channel = provider.connect(name, options);
+        channels[ch->id] = std::move(m_channel);
+    }
+    *channel = reinterpret_cast<chid>(ch);
+    ch->channel.addConnectListener(ch);
+    return ECA_NORMAL;
+}
+
+//Like ca_clear_channel, this also clears the channel's subscriptions
+int caPvaTransport::clear_channel(chid channel) {
+    pvaChannel* ch = _channel(channel);
+    std::vector<pvaOperation*> m_operations;
+    std::vector<pvaSubscription*> m_subscriptions;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto& entry : operations) {
+            if (entry.second->channel == channel) {
+                m_operations.push_back(entry.second.get());
+            }
+        }
+        for (auto& entry : subscriptions) {
+            if (entry.second->channel == channel) {
+                m_subscriptions.push_back(entry.second.get());
+            }
+        }
+    }
+    _cancel(m_operations);
+    //Cancelled outside the lock, since cancel waits for a callback that may be taking it
+    for (pvaSubscription* sub : m_subscriptions) {
+        sub->monitor.cancel();
+    }
+    ch->channel.removeConnectListener(ch);
+    ch->probe.cancel();
+    std::lock_guard<std::mutex> lock(mutex);
+    for (pvaSubscription* sub : m_subscriptions) {
+        subscriptions.erase(sub->id);
+    }
+    channels.erase(ch->id);
+    return ECA_NORMAL;
+}
+
+int caPvaTransport::_start_get(chtype type, unsigned long count, chid channel, void* value,
+                               caEventCallBackFunc* callback, void* usr) {
+    pvaChannel* ch = _channel(channel);
+    pvaOperation* operation;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        _reap();
+        if (!ch->connected) {
+            return ECA_DISCONN;
+        }
+        std::unique_ptr<pvaOperation> m_operation = std::make_unique<pvaOperation>();
+        operation = m_operation.get();
+        operation->owner = this;
+        operation->id = nextId++;
+        operation->channel = channel;
+        operation->type = type;
+        operation->count = count == 0 ? ch->count : count;
+        operation->value = value;
+        operation->callback = callback;
+        operation->usr = usr;
+        if (callback == nullptr) {
+            outstanding++;
+        }
+        operations[operation->id] = std::move(m_operation);
+    }
+    pvac::Operation m_pending = ch->channel.get(operation, pvd::createRequest(request_for(type)));
+    std::lock_guard<std::mutex> lock(mutex);
+    operation->operation = m_pending;
+    operation->started = true;
+    return ECA_NORMAL;
+}
+
+int caPvaTransport::_start_put(chtype type, unsigned long count, chid channel, const void* value,
+                               caEventCallBackFunc* callback, void* usr) {
+    if (type < DBR_STRING || type > DBR_DOUBLE) {
+        return ECA_BADTYPE;
+    }
+    pvaChannel* ch = _channel(channel);
+    pvaOperation* operation;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        _reap();
+        if (!ch->connected) {
+            return ECA_DISCONN;
+        }
+        std::unique_ptr<pvaOperation> m_operation = std::make_unique<pvaOperation>();
+        operation = m_operation.get();
+        operation->owner = this;
+        operation->id = nextId++;
+        operation->channel = channel;
+        operation->type = type;
+        operation->count = count;
+        const char* in = static_cast<const char*>(value);
+        operation->data.assign(in, in + count * dbr_value_size[type]);
+        operation->callback = callback;
+        operation->usr = usr;
+        if (callback == nullptr) {
+            outstanding++;
+        }
+        operations[operation->id] = std::move(m_operation);
+    }
+    //String puts get the previous value too, for the choices of an enum
+    pvac::Operation m_pending = ch->channel.put(operation, pvd::createRequest("field(value)"), type == DBR_STRING);
+    std::lock_guard<std::mutex> lock(mutex);
+    operation->operation = m_pending;
+    operation->started = true;
+    return ECA_NORMAL;
+}
+
+int caPvaTransport::array_get(chtype type, unsigned long count, chid channel, void* value) {
+    return _start_get(type, count, channel, value, nullptr, nullptr);
+}
+
+int caPvaTransport::array_get_callback(chtype type, unsigned long count, chid channel,
+                                       caEventCallBackFunc* callback, void* usr) {
+    return _start_get(type, count, channel, nullptr, callback, usr);
+}
+
+int caPvaTransport::array_put(chtype type, unsigned long count, chid channel, const void* value) {
+    return _start_put(type, count, channel, value, nullptr, nullptr);
+}
+
+int caPvaTransport::array_put_callback(chtype type, unsigned long count, chid channel, const void* value,
+                                       caEventCallBackFunc* callback, void* usr) {
+    return _start_put(type, count, channel, value, callback, usr);
+}
+
+int caPvaTransport::create_subscription(chtype type, unsigned long count, chid channel, long,
+                                        caEventCallBackFunc* callback, void* usr, evid* monitor) {
+    pvaChannel* ch = _channel(channel);
+    pvaSubscription* sub;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::unique_ptr<pvaSubscription> m_sub = std::make_unique<pvaSubscription>();
+        sub = m_sub.get();
+        sub->owner = this;
+        sub->id = nextId++;
+        sub->channel = channel;
+        sub->type = type;
+        sub->count = count;
+        sub->callback = callback;
+        sub->usr = usr;
+        subscriptions[sub->id] = std::move(m_sub);
+    }
+    std::string request = config.monitor_options;
+    if (!request.empty()) {
+        request += " ";
+    }
+    request += request_for(type);
+    pvac::Monitor m_monitor = ch->channel.monitor(sub, pvd::createRequest(request));
+    std::lock_guard<std::mutex> lock(mutex);
+    sub->monitor = m_monitor;
+    *monitor = reinterpret_cast<evid>(sub);
+    return ECA_NORMAL;
+}
+
+int caPvaTransport::clear_subscription(evid monitor) {
+    pvaSubscription* sub = reinterpret_cast<pvaSubscription*>(monitor);
+    sub->monitor.cancel();
+    std::lock_guard<std::mutex> lock(mutex);
+    subscriptions.erase(sub->id);
+    return ECA_NORMAL;
+}
+
+//Waits for every get and put without callback; on timeout they are cancelled as in CA
+int caPvaTransport::pend_io(double timeout) {
+    std::vector<pvaOperation*> m_operations;
+    int status;
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::duration<double>(timeout);
+        bool complete = done.wait_until(lock, deadline, [this]() {return outstanding == 0;});
+        if (complete) {
+            status = pendingFailure ? ECA_GETFAIL : ECA_NORMAL;
+        } else {
+            status = ECA_TIMEOUT;
+            for (auto& entry : operations) {
+                if (entry.second->callback == nullptr && !entry.second->finished) {
+                    m_operations.push_back(entry.second.get());
+                }
+            }
+            outstanding = 0;
+        }
+        pendingFailure = false;
+        _reap();
+    }
+    _cancel(m_operations);
+    return status;
+}
+
+//pvAccess delivers callbacks on its own threads, so there is nothing to dispatch
+int caPvaTransport::pend_event(double timeout) {
+    std::this_thread::sleep_for(std::chrono::duration<double>(timeout));
+    return ECA_TIMEOUT;
+}
+
+//pvAccess sends requests as they are issued
+int caPvaTransport::flush_io() {
+    return ECA_NORMAL;
+}
+
+int caPvaTransport::add_exception_event(caExceptionHandler* handler, void* usr) {
+    std::lock_guard<std::mutex> lock(mutex);
+    exceptionHandler = handler;
+    exceptionUsr = usr;
+    return ECA_NORMAL;
+}
+
+chtype caPvaTransport::field_type(chid channel) {
+    std::lock_guard<std::mutex> lock(mutex);
+    pvaChannel* ch = _channel(channel);
+    return ch->everConnected ? ch->type : TYPENOTCONN;
+}
+
+unsigned long caPvaTransport::element_count(chid channel) {
+    std::lock_guard<std::mutex> lock(mutex);
+    pvaChannel* ch = _channel(channel);
+    return ch->connected ? ch->count : 0;
+}
+
+enum channel_state caPvaTransport::state(chid channel) {
+    std::lock_guard<std::mutex> lock(mutex);
+    pvaChannel* ch = _channel(channel);
+    if (ch->connected) {
+        return cs_conn;
+    }
+    return ch->everConnected ? cs_prev_conn : cs_never_conn;
+}
+
+const char* caPvaTransport::name(chid channel) {
+    return _channel(channel)->name.c_str();
+}
+
+void* caPvaTransport::puser(chid channel) {
+    return _channel(channel)->puser;
+}
+} // namespace epics
+#endif // EPICS_PROXY_WITH_PVA
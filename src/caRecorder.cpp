@@ -0,0 +1,230 @@
+/**
+ * @file caRecorder.cpp
+ * @brief Implementation of the memory-mapped ring-buffer recorder for monitored PVs.
+ */
+
+#include "caRecorder.h"
+#include "PV.h"
+#include "caTransport.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace epics {
+
+static_assert(sizeof(ringRecord) == 64, "ringRecord must stay one cache line");
+static_assert(std::atomic_ref<uint64_t>::is_always_lock_free, "Ring file needs lock-free 64-bit atomics");
+
+static const char ringMagic[8] = {'E', 'P', 'R', 'I', 'N', 'G', '0', '1'};
+
+caRecorder::caRecorder(std::string m_path, std::vector<std::string> m_pvNames, std::size_t m_capacity) {
+    path = m_path;
+    if (m_capacity == 0) {
+        throw std::runtime_error("Recorder capacity must be greater than zero");
+    }
+    long page = sysconf(_SC_PAGESIZE);
+    std::size_t names_end = sizeof(ringFileHeader) + m_pvNames.size() * name_size;
+    std::size_t records_offset = (names_end + page - 1) / page * page;
+    mappingSize = records_offset + m_capacity * sizeof(ringRecord);
+
+    fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to open recorder file " + path + ": " + std::strerror(errno));
+    }
+    //Reserve the blocks now so a full disk fails here and not with SIGBUS in a callback
+    int rc = posix_fallocate(fd, 0, static_cast<off_t>(mappingSize));
+    if (rc != 0) {
+        close(fd);
+        throw std::runtime_error("Failed to allocate recorder file " + path + ": " + std::strerror(rc));
+    }
+    mapping = mmap(nullptr, mappingSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapping == MAP_FAILED) {
+        close(fd);
+        throw std::runtime_error("Failed to map recorder file " + path + ": " + std::strerror(errno));
+    }
+
+    header = static_cast<ringFileHeader*>(mapping);
+    std::memset(mapping, 0, records_offset);
+    std::memcpy(header->magic, ringMagic, sizeof(ringMagic));
+    header->version = 1;
+    header->record_size = sizeof(ringRecord);
+    header->capacity = m_capacity;
+    header->pv_count = static_cast<uint32_t>(m_pvNames.size());
+    header->name_size = name_size;
+    header->records_offset = records_offset;
+    header->write_index = 0;
+
+    char* names = static_cast<char*>(mapping) + sizeof(ringFileHeader);
+    for (std::size_t i = 0; i < m_pvNames.size(); i++) {
+        std::strncpy(names + i * name_size, m_pvNames[i].c_str(), name_size - 1);
+    }
+    records = reinterpret_cast<ringRecord*>(static_cast<char*>(mapping) + records_offset);
+}
+
+caRecorder::~caRecorder() {
+    stop();
+    if (mapping != nullptr) {
+        msync(mapping, mappingSize, MS_ASYNC);
+        munmap(mapping, mappingSize);
+    }
+    if (fd >= 0) {
+        close(fd);
+    }
+}
+
+bool caRecorder::add(PV* m_pv, uint32_t m_pvIndex) {
+    if (m_pvIndex >= header->pv_count) {
+        throw std::runtime_error("Recorder index out of range for PV " + m_pv->get_name());
+    }
+    sharedChannel* channel = m_pv->get_shared_channel();
+    chtype m_fieldType = get_transport()->field_type(channel->channel);
+    if (m_fieldType == TYPENOTCONN) {
+        return false;
+    }
+    std::unique_ptr<subscription> sub(new subscription{this, m_pvIndex, nullptr});
+    sub->monitor = caChannelTable::instance().subscribe(channel, dbf_type_to_DBR_TIME(m_fieldType), 1,
+                                                        DBE_VALUE | DBE_ALARM, event_callback, sub.get());
+    subscriptions.push_back(sub.release());
+    return true;
+}
+
+void caRecorder::stop() {
+    for (subscription* sub : subscriptions) {
+        caChannelTable::instance().unsubscribe(sub->monitor, sub);
+        delete sub;
+    }
+    subscriptions.clear();
+}
+
+uint64_t caRecorder::get_write_index() {
+    return std::atomic_ref<uint64_t>(header->write_index).load(std::memory_order_acquire);
+}
+
+void caRecorder::event_callback(struct event_handler_args args) {
+    subscription* sub = static_cast<subscription*>(args.usr);
+    if (args.status != ECA_NORMAL || args.dbr == nullptr) {
+        return;
+    }
+    sub->recorder->_append(sub->pv_index, args);
+}
+
+//Called concurrently from any number of CA callback threads
+void caRecorder::_append(uint32_t pv_index, const struct event_handler_args& args) {
+    uint64_t index = std::atomic_ref<uint64_t>(header->write_index).fetch_add(1, std::memory_order_relaxed);
+    ringRecord& record = records[index % header->capacity];
+    std::atomic_ref<uint64_t> seq(record.seq);
+
+    seq.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    //All DBR_TIME_ structures start with status, severity and stamp
+    const struct dbr_time_double* time = static_cast<const struct dbr_time_double*>(args.dbr);
+    record.sec_past_epoch = time->stamp.secPastEpoch;
+    record.nsec = time->stamp.nsec;
+    record.pv_index = pv_index;
+    record.dbr_type = static_cast<int16_t>(args.type - DBR_TIME_STRING);
+    record.severity = time->severity;
+    record.status = time->status;
+    record.count = static_cast<uint32_t>(args.count);
+    std::size_t bytes = static_cast<std::size_t>(args.count) * dbr_value_size[args.type];
+    if (bytes > sizeof(record.value)) {
+        bytes = sizeof(record.value);
+    }
+    std::memcpy(record.value, dbr_value_ptr(args.dbr, args.type), bytes);
+
+    seq.store(index + 1, std::memory_order_release);
+}
+
+caRingReader::caRingReader(std::string m_path) {
+    fd = open(m_path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to open recorder file " + m_path + ": " + std::strerror(errno));
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < sizeof(ringFileHeader)) {
+        close(fd);
+        throw std::runtime_error("Recorder file " + m_path + " is truncated");
+    }
+    mappingSize = static_cast<std::size_t>(st.st_size);
+    mapping = mmap(nullptr, mappingSize, PROT_READ, MAP_SHARED, fd, 0);
+    if (mapping == MAP_FAILED) {
+        close(fd);
+        throw std::runtime_error("Failed to map recorder file " + m_path + ": " + std::strerror(errno));
+    }
+    header = static_cast<const ringFileHeader*>(mapping);
+    if (std::memcmp(header->magic, ringMagic, sizeof(ringMagic)) != 0 ||
+        header->record_size != sizeof(ringRecord) ||
+        header->records_offset + header->capacity * sizeof(ringRecord) > mappingSize) {
+        munmap(mapping, mappingSize);
+        close(fd);
+        throw std::runtime_error("File " + m_path + " is not a recorder ring file");
+    }
+    const char* names = static_cast<const char*>(mapping) + sizeof(ringFileHeader);
+    for (uint32_t i = 0; i < header->pv_count; i++) {
+        const char* name = names + i * header->name_size;
+        pvNames.push_back(std::string(name, strnlen(name, header->name_size)));
+    }
+    records = reinterpret_cast<const ringRecord*>(static_cast<const char*>(mapping) + header->records_offset);
+}
+
+caRingReader::~caRingReader() {
+    munmap(mapping, mappingSize);
+    close(fd);
+}
+
+std::vector<ringRecord> caRingReader::read(double last_seconds) {
+    uint64_t end = std::atomic_ref<uint64_t>(const_cast<uint64_t&>(header->write_index)).load(std::memory_order_acquire);
+    uint64_t begin = end > header->capacity ? end - header->capacity : 0;
+
+    std::vector<ringRecord> result;
+    result.reserve(end - begin);
+    for (uint64_t index = begin; index < end; index++) {
+        const ringRecord& slot = records[index % header->capacity];
+        std::atomic_ref<uint64_t> seq(const_cast<uint64_t&>(slot.seq));
+        if (seq.load(std::memory_order_acquire) != index + 1) {
+            continue;
+        }
+        ringRecord copy;
+        std::memcpy(&copy, &slot, sizeof(copy));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        //Overwritten while copying
+        if (seq.load(std::memory_order_relaxed) != index + 1) {
+            continue;
+        }
+        result.push_back(copy);
+    }
+
+    if (last_seconds > 0.0 && !result.empty()) {
+        double newest = 0.0;
+        for (const ringRecord& record : result) {
+            newest = std::max(newest, record.sec_past_epoch + record.nsec * 1e-9);
+        }
+        std::erase_if(result, [&](const ringRecord& record) {
+            return record.sec_past_epoch + record.nsec * 1e-9 < newest - last_seconds;
+        });
+    }
+    return result;
+}
+
+double caRingReader::value_as_double(const ringRecord& record) {
+    switch (record.dbr_type) {
+        case DBR_DOUBLE: {dbr_double_t v; std::memcpy(&v, record.value, sizeof(v)); return v;}
+        case DBR_FLOAT: {dbr_float_t v; std::memcpy(&v, record.value, sizeof(v)); return v;}
+        case DBR_LONG: {dbr_long_t v; std::memcpy(&v, record.value, sizeof(v)); return v;}
+        case DBR_SHORT: {dbr_short_t v; std::memcpy(&v, record.value, sizeof(v)); return v;}
+        case DBR_ENUM: {dbr_enum_t v; std::memcpy(&v, record.value, sizeof(v)); return v;}
+        case DBR_CHAR: {dbr_char_t v; std::memcpy(&v, record.value, sizeof(v)); return v;}
+        default:
+            throw std::runtime_error("Recorded type " + std::to_string(record.dbr_type) + " is not numeric");
+    }
+}
+} // namespace epics
@@ -0,0 +1,34 @@
+/**
+ * @file caReduction.cpp
+ * @brief Statistics of array monitor events computed in the CA callback.
+ */
+
+#include "caReduction.h"
+
+namespace epics {
+
+caReduction::caReduction(reductionCallback* m_callback, void* m_usr) {
+    callback = m_callback;
+    usr = m_usr;
+}
+
+void caReduction::process(const void* m_values, chtype m_type, unsigned long m_count) {
+    arrayStats stats = caConvert::reduce(m_values, m_type, m_count);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        last = stats;
+        sequence++;
+    }
+    if (callback != nullptr) {
+        callback(stats, usr);
+    }
+}
+
+arrayStats caReduction::latest(uint64_t* m_sequence) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (m_sequence != nullptr) {
+        *m_sequence = sequence;
+    }
+    return last;
+}
+} // namespace epics
@@ -0,0 +1,176 @@
+/**
+ * @file caReplay.cpp
+ * @brief Implementation of the replay source that feeds recorded PV history to monitor callbacks.
+ */
+
+#include "caReplay.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+namespace epics {
+
+uint32_t caReplay::_intern(const std::string& m_pvName) {
+    auto [it, inserted] = nameIndex.try_emplace(m_pvName, static_cast<uint32_t>(names.size()));
+    if (inserted) {
+        names.push_back(m_pvName);
+    }
+    return it->second;
+}
+
+void caReplay::load(std::string m_path) {
+    std::ifstream input(m_path);
+    if (!input) {
+        throw std::runtime_error("Failed to open replay file " + m_path);
+    }
+    std::string line;
+    std::size_t lineNumber = 0;
+    while (std::getline(input, line)) {
+        lineNumber++;
+        std::istringstream fields(line);
+        std::string time;
+        std::string pvName;
+        if (!(fields >> time) || time[0] == '#') {
+            continue;
+        }
+        char* end = nullptr;
+        replayEvent event;
+        event.time = std::strtod(time.c_str(), &end);
+        if (*end != '\0' || !(fields >> pvName)) {
+            throw std::runtime_error("Malformed replay event at " + m_path + ":" + std::to_string(lineNumber));
+        }
+        event.name = _intern(pvName);
+
+        std::string rest;
+        std::getline(fields >> std::ws, rest);
+        std::istringstream tokens(rest);
+        std::string token;
+        bool numeric = true;
+        while (tokens >> token) {
+            double value = std::strtod(token.c_str(), &end);
+            if (*end != '\0') {
+                numeric = false;
+                break;
+            }
+            event.values.push_back(value);
+        }
+        if (!numeric || event.values.empty()) {
+            event.values.clear();
+            event.text = rest;
+        }
+        events.push_back(event);
+    }
+    std::stable_sort(events.begin(), events.end(),
+                     [](const replayEvent& a, const replayEvent& b) {return a.time < b.time;});
+}
+
+void caReplay::add_monitor(std::string m_pvName, void* usr, void (*callback)(struct event_handler_args args),
+                           chtype type) {
+    if (type != DBR_STRING && type != DBR_SHORT && type != DBR_FLOAT && type != DBR_ENUM &&
+        type != DBR_CHAR && type != DBR_LONG && type != DBR_DOUBLE) {
+        throw std::runtime_error("Replay type " + std::to_string(type) + " not supported");
+    }
+    subscribers.push_back({m_pvName, type, usr, callback});
+}
+
+void caReplay::remove_monitor(std::string m_pvName) {
+    std::erase_if(subscribers, [&](const subscriber& sub) {return sub.pvName == m_pvName;});
+}
+
+template<typename TypeValue>
+static void fill(std::vector<char>& buffer, const std::vector<double>& values) {
+    buffer.resize(values.size() * sizeof(TypeValue));
+    TypeValue* out = reinterpret_cast<TypeValue*>(buffer.data());
+    for (std::size_t i = 0; i < values.size(); i++) {
+        out[i] = static_cast<TypeValue>(values[i]);
+    }
+}
+
+//Returns false when the event cannot be given to this subscriber
+bool caReplay::_deliver(const replayEvent& event, const subscriber& sub, std::vector<char>& buffer) {
+    long count = 1;
+    if (sub.type == DBR_STRING) {
+        //Numeric events are formatted the way a DBR_STRING request of the IOC would be
+        std::string text = event.text;
+        if (event.values.size() > 0) {
+            std::ostringstream formatted;
+            formatted << event.values[0];
+            text = formatted.str();
+        }
+        buffer.assign(sizeof(dbr_string_t), '\0');
+        std::strncpy(buffer.data(), text.c_str(), sizeof(dbr_string_t) - 1);
+    } else if (event.values.empty()) {
+        //A string event cannot be delivered to a numeric subscriber
+        return false;
+    } else {
+        count = static_cast<long>(event.values.size());
+        switch (sub.type) {
+            case DBR_DOUBLE: fill<dbr_double_t>(buffer, event.values); break;
+            case DBR_FLOAT: fill<dbr_float_t>(buffer, event.values); break;
+            case DBR_LONG: fill<dbr_long_t>(buffer, event.values); break;
+            case DBR_SHORT: fill<dbr_short_t>(buffer, event.values); break;
+            case DBR_ENUM: fill<dbr_enum_t>(buffer, event.values); break;
+            case DBR_CHAR: fill<dbr_char_t>(buffer, event.values); break;
+        }
+    }
+    struct event_handler_args args;
+    args.usr = sub.usr;
+    args.chid = nullptr;
+    args.type = sub.type;
+    args.count = count;
+    args.dbr = buffer.data();
+    args.status = ECA_NORMAL;
+    sub.callback(args);
+    return true;
+}
+
+replayStats caReplay::run(double speed) {
+    replayStats stats;
+    stopRequested = false;
+
+    //Resolve subscribers per name once instead of comparing strings per event
+    std::vector<std::vector<const subscriber*>> byName(names.size());
+    for (const subscriber& sub : subscribers) {
+        auto it = nameIndex.find(sub.pvName);
+        if (it != nameIndex.end()) {
+            byName[it->second].push_back(&sub);
+        }
+    }
+
+    std::vector<char> buffer;
+    auto start = std::chrono::steady_clock::now();
+    double firstTime = events.empty() ? 0.0 : events.front().time;
+    for (const replayEvent& event : events) {
+        if (stopRequested) {
+            break;
+        }
+        if (speed > 0.0) {
+            auto due = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                   std::chrono::duration<double>((event.time - firstTime) / speed));
+            std::this_thread::sleep_until(due);
+            double lag = std::chrono::duration<double>(std::chrono::steady_clock::now() - due).count();
+            stats.max_lag = std::max(stats.max_lag, lag);
+        }
+        if (byName[event.name].empty()) {
+            stats.skipped++;
+            continue;
+        }
+        for (const subscriber* sub : byName[event.name]) {
+            if (_deliver(event, *sub, buffer)) {
+                stats.events++;
+            } else {
+                stats.skipped++;
+            }
+        }
+    }
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    stats.events_per_second = stats.seconds > 0.0 ? stats.events / stats.seconds : 0.0;
+    return stats;
+}
+} // namespace epics
@@ -0,0 +1,720 @@
+/**
+ * @file caSimTransport.cpp
+ * @brief Implementation of the in-process simulated Channel Access transport.
+ */
+
+#include "caSimTransport.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+namespace epics {
+
+//Seconds between the POSIX and EPICS epochs
+static const uint32_t epicsEpochOffset = 631152000u;
+
+caSimTransport::caSimTransport(simConfig m_config) : config(m_config), rng(m_config.seed) {
+}
+
+caSimTransport::~caSimTransport() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        running = false;
+    }
+    wake.notify_all();
+    if (worker.joinable()) {
+        worker.join();
+    }
+    for (auto& entry : subscriptions) {
+        delete entry.second;
+    }
+    for (auto& entry : channels) {
+        delete entry.second;
+    }
+    for (auto& entry : pvs) {
+        delete entry.second;
+    }
+}
+
+void caSimTransport::set_config(simConfig m_config) {
+    std::lock_guard<std::mutex> lock(mutex);
+    config = m_config;
+    rng.seed(config.seed);
+}
+
+void caSimTransport::add_pv(std::string m_name, chtype type, unsigned long count, double initial) {
+    std::lock_guard<std::mutex> lock(mutex);
+    simPV* pv = pvs[m_name];
+    if (pv == nullptr) {
+        pv = new simPV();
+        pvs[m_name] = pv;
+    }
+    pv->name = m_name;
+    pv->type = type;
+    pv->count = count;
+    pv->values.assign(count, initial);
+    _stamp(pv);
+}
+
+void caSimTransport::set_value(std::string m_name, std::vector<double> m_values) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = pvs.find(m_name);
+    if (it == pvs.end()) {
+        throw std::runtime_error("Simulated PV " + m_name + " not found");
+    }
+    simPV* pv = it->second;
+    if (m_values.size() > pv->count) {
+        m_values.resize(pv->count);
+    }
+    pv->values = m_values;
+    _stamp(pv);
+    _changed(pv);
+}
+
+std::vector<double> caSimTransport::get_value(std::string m_name) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = pvs.find(m_name);
+    if (it == pvs.end()) {
+        throw std::runtime_error("Simulated PV " + m_name + " not found");
+    }
+    return it->second->values;
+}
+
+void caSimTransport::set_update_rate(std::string m_name, double hz) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = pvs.find(m_name);
+    if (it == pvs.end()) {
+        throw std::runtime_error("Simulated PV " + m_name + " not found");
+    }
+    it->second->update_rate = hz;
+    if (hz > 0.0) {
+        nextUpdate[m_name] = clock::now();
+    } else {
+        nextUpdate.erase(m_name);
+    }
+    wake.notify_all();
+}
+
+void caSimTransport::disconnect(std::string m_name) {
+    _set_connected(m_name, false);
+}
+
+void caSimTransport::reconnect(std::string m_name) {
+    _set_connected(m_name, true);
+}
+
+void caSimTransport::_set_connected(std::string m_name, bool m_connected) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = pvs.find(m_name);
+    if (it == pvs.end()) {
+        throw std::runtime_error("Simulated PV " + m_name + " not found");
+    }
+    simPV* pv = it->second;
+    if (pv->connected == m_connected) {
+        return;
+    }
+    pv->connected = m_connected;
+    for (auto& entry : channels) {
+        simChannel* ch = entry.second;
+        if (ch->pv != pv || ch->conn_callback == nullptr) {
+            continue;
+        }
+        uint64_t id = ch->id;
+        _schedule(_due(), [this, id, m_connected]() {
+            caCh* callback = nullptr;
+            chid channel = nullptr;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                auto found = channels.find(id);
+                if (found == channels.end()) {
+                    return;
+                }
+                callback = found->second->conn_callback;
+                channel = reinterpret_cast<chid>(found->second);
+            }
+            struct connection_handler_args args;
+            args.chid = channel;
+            args.op = m_connected ? CA_OP_CONN_UP : CA_OP_CONN_DOWN;
+            callback(args);
+        });
+    }
+    //Monitors resend the current value when the connection comes back
+    if (m_connected) {
+        _changed(pv);
+    }
+}
+
+//Worker thread: runs scheduled replies and periodic PV updates
+void caSimTransport::_run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (running) {
+        auto now = clock::now();
+        auto next = clock::time_point::max();
+        for (auto& entry : nextUpdate) {
+            simPV* pv = pvs[entry.first];
+            auto period = std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(1.0 / pv->update_rate));
+            if (entry.second <= now) {
+                for (double& value : pv->values) {
+                    value += 1.0;
+                }
+                _stamp(pv);
+                _changed(pv);
+                //Skip missed periods rather than bursting to catch up
+                entry.second = std::max(entry.second + period, now);
+            }
+            next = std::min(next, entry.second);
+        }
+        if (!tasks.empty() && tasks.begin()->first <= now) {
+            std::function<void()> task = std::move(tasks.begin()->second);
+            tasks.erase(tasks.begin());
+            inCallback = true;
+            lock.unlock();
+            task();
+            lock.lock();
+            inCallback = false;
+            callbackDone.notify_all();
+            continue;
+        }
+        if (!tasks.empty()) {
+            next = std::min(next, tasks.begin()->first);
+        }
+        if (next == clock::time_point::max()) {
+            wake.wait(lock);
+        } else {
+            wake.wait_until(lock, next);
+        }
+    }
+}
+
+//Like CA, clearing a channel or subscription waits for a callback in progress, unless
+//the callback itself is the caller
+void caSimTransport::_wait_callback(std::unique_lock<std::mutex>& lock) {
+    if (std::this_thread::get_id() != worker.get_id()) {
+        callbackDone.wait(lock, [this]() {return !inCallback;});
+    }
+}
+
+//Caller must hold the mutex
+void caSimTransport::_schedule(clock::time_point due, std::function<void()> task) {
+    tasks.emplace(due, std::move(task));
+    wake.notify_all();
+}
+
+//Caller must hold the mutex
+caSimTransport::clock::time_point caSimTransport::_due() {
+    double delay = config.latency;
+    if (config.jitter > 0.0) {
+        delay += std::uniform_real_distribution<double>(0.0, config.jitter)(rng);
+    }
+    return clock::now() + std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(delay));
+}
+
+//Caller must hold the mutex
+bool caSimTransport::_fail() {
+    return config.failure_rate > 0.0 && std::uniform_real_distribution<double>(0.0, 1.0)(rng) < config.failure_rate;
+}
+
+caSimTransport::simChannel* caSimTransport::_channel(chid channel) {
+    return reinterpret_cast<simChannel*>(channel);
+}
+
+//Caller must hold the mutex
+bool caSimTransport::_connected(simChannel* channel) {
+    return channel->pv != nullptr && channel->pv->connected && clock::now() >= channel->connectAt;
+}
+
+//Caller must hold the mutex. Posts a monitor event to every value subscriber of pv.
+void caSimTransport::_changed(simPV* pv) {
+    for (uint64_t id : pv->subscriptions) {
+        if (subscriptions[id]->mask & DBE_VALUE) {
+            _schedule(_due(), [this, id]() {_deliver(id);});
+        }
+    }
+}
+
+void caSimTransport::_deliver(uint64_t subscription) {
+    std::vector<char> buffer;
+    struct event_handler_args args;
+    caEventCallBackFunc* callback;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto found = subscriptions.find(subscription);
+        if (found == subscriptions.end()) {
+            return;
+        }
+        simSubscription* sub = found->second;
+        simChannel* ch = channels[sub->channel];
+        if (!_connected(ch)) {
+            return;
+        }
+        unsigned long count = sub->count == 0 ? _visible(ch, ch->pv->values.size()) : sub->count;
+        buffer.resize(dbr_size_n(sub->type, count));
+        args.status = _encode(*ch->pv, sub->type, count, buffer.data(), ch->first);
+        args.usr = sub->usr;
+        args.chid = reinterpret_cast<chid>(ch);
+        args.type = sub->type;
+        args.count = static_cast<long>(count);
+        args.dbr = args.status == ECA_NORMAL ? buffer.data() : nullptr;
+        callback = sub->callback;
+    }
+    callback(args);
+}
+
+void caSimTransport::_stamp(simPV* pv) {
+    auto now = std::chrono::system_clock::now().time_since_epoch();
+    auto seconds = std::chrono::duration_cast<std::chrono::seconds>(now);
+    pv->stamp.secPastEpoch = static_cast<uint32_t>(seconds.count()) - epicsEpochOffset;
+    pv->stamp.nsec = static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now - seconds).count());
+}
+
+//Elements of a PV with count elements seen through the channel's array filter window
+unsigned long caSimTransport::_visible(const simChannel* channel, unsigned long count) {
+    unsigned long end = channel->last < count ? channel->last + 1 : count;
+    return end > channel->first ? end - channel->first : 0;
+}
+
+//Convert a PV, from element first on, into a plain DBR_ or DBR_TIME_ buffer of count elements
+int caSimTransport::_encode(const simPV& pv, chtype type, unsigned long count, void* value, unsigned long first) {
+    chtype plain = type;
+    char* out = static_cast<char*>(value);
+    if (type >= DBR_TIME_STRING && type <= DBR_TIME_DOUBLE) {
+        //All DBR_TIME_ structures start with status, severity and stamp
+        struct dbr_time_double* header = static_cast<struct dbr_time_double*>(value);
+        header->status = 0;
+        header->severity = 0;
+        header->stamp = pv.stamp;
+        plain = static_cast<chtype>(type - DBR_TIME_STRING);
+        out = static_cast<char*>(dbr_value_ptr(value, type));
+    } else if (type < DBR_STRING || type > DBR_DOUBLE) {
+        return ECA_BADTYPE;
+    }
+    for (unsigned long i = 0; i < count; i++) {
+        double v = first + i < pv.values.size() ? pv.values[first + i] : 0.0;
+        switch (plain) {
+            case DBR_STRING: {
+                std::string text = pv.text;
+                if (pv.type != DBR_STRING) {
+                    std::ostringstream formatted;
+                    formatted << v;
+                    text = formatted.str();
+                }
+                char* slot = out + i * sizeof(dbr_string_t);
+                std::memset(slot, 0, sizeof(dbr_string_t));
+                std::strncpy(slot, text.c_str(), sizeof(dbr_string_t) - 1);
+                break;
+            }
+            case DBR_SHORT: reinterpret_cast<dbr_short_t*>(out)[i] = static_cast<dbr_short_t>(v); break;
+            case DBR_FLOAT: reinterpret_cast<dbr_float_t*>(out)[i] = static_cast<dbr_float_t>(v); break;
+            case DBR_ENUM: reinterpret_cast<dbr_enum_t*>(out)[i] = static_cast<dbr_enum_t>(v); break;
+            case DBR_CHAR: reinterpret_cast<dbr_char_t*>(out)[i] = static_cast<dbr_char_t>(v); break;
+            case DBR_LONG: reinterpret_cast<dbr_long_t*>(out)[i] = static_cast<dbr_long_t>(v); break;
+            case DBR_DOUBLE: reinterpret_cast<dbr_double_t*>(out)[i] = v; break;
+        }
+    }
+    return ECA_NORMAL;
+}
+
+//Store a plain DBR_ buffer into a PV, like a put to a waveform setting NORD
+int caSimTransport::_decode(simPV& pv, chtype type, unsigned long count, const void* value) {
+    if (type < DBR_STRING || type > DBR_DOUBLE) {
+        return ECA_BADTYPE;
+    }
+    if (count > pv.count) {
+        return ECA_BADCOUNT;
+    }
+    const char* in = static_cast<const char*>(value);
+    std::vector<double> values(count);
+    for (unsigned long i = 0; i < count; i++) {
+        switch (type) {
+            case DBR_STRING: {
+                const char* slot = in + i * sizeof(dbr_string_t);
+                std::string text(slot, strnlen(slot, sizeof(dbr_string_t)));
+                if (pv.type == DBR_STRING) {
+                    pv.text = text;
+                }
+                values[i] = std::strtod(text.c_str(), nullptr);
+                break;
+            }
+            case DBR_SHORT: values[i] = reinterpret_cast<const dbr_short_t*>(in)[i]; break;
+            case DBR_FLOAT: values[i] = reinterpret_cast<const dbr_float_t*>(in)[i]; break;
+            case DBR_ENUM: values[i] = reinterpret_cast<const dbr_enum_t*>(in)[i]; break;
+            case DBR_CHAR: values[i] = reinterpret_cast<const dbr_char_t*>(in)[i]; break;
+            case DBR_LONG: values[i] = reinterpret_cast<const dbr_long_t*>(in)[i]; break;
+            case DBR_DOUBLE: values[i] = reinterpret_cast<const dbr_double_t*>(in)[i]; break;
+        }
+    }
+    pv.values = values;
+    _stamp(&pv);
+    return ECA_NORMAL;
+}
+
+int caSimTransport::context_create(enum ca_preemptive_callback_select) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (contexts++ == 0) {
+        running = true;
+        worker = std::thread(&caSimTransport::_run, this);
+    }
+    return ECA_NORMAL;
+}
+
+void caSimTransport::context_destroy() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--contexts > 0) {
+            return;
+        }
+        running = false;
+    }
+    wake.notify_all();
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+//There is no CA client context behind the simulation
+struct ca_client_context* caSimTransport::current_context() {
+    return nullptr;
+}
+
+//The simulation has one context shared by all threads
+int caSimTransport::attach_context(struct ca_client_context*) {
+    return ECA_NORMAL;
+}
+
+void caSimTransport::detach_context() {
+}
+
+int caSimTransport::create_channel(const char* name, caCh* conn_callback, void* puser, unsigned, chid* channel) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = pvs.find(name);
+    simPV* pv = nullptr;
+    unsigned long first = 0;
+    unsigned long last = ~0UL;
+    //An array filter on a defined PV: "wf.[first:last]" or "wf.VAL[first:last]"
+    std::string filtered = name;
+    std::size_t bracket = filtered.rfind('[');
+    auto base = pvs.end();
+    if (it == pvs.end() && bracket != std::string::npos && filtered.back() == ']') {
+        std::string prefix = filtered.substr(0, bracket);
+        if (prefix.size() > 4 && prefix.compare(prefix.size() - 4, 4, ".VAL") == 0) {
+            prefix.resize(prefix.size() - 4);
+        } else if (!prefix.empty() && prefix.back() == '.') {
+            prefix.pop_back();
+        }
+        base = pvs.find(prefix);
+        if (base != pvs.end()) {
+            std::string range = filtered.substr(bracket + 1, filtered.size() - bracket - 2);
+            std::size_t colon = range.find(':');
+            first = std::strtoul(range.c_str(), nullptr, 10);
+            last = colon == std::string::npos ? first : std::strtoul(range.c_str() + colon + 1, nullptr, 10);
+        }
+    }
+    if (it != pvs.end()) {
+        pv = it->second;
+    } else if (base != pvs.end()) {
+        pv = base->second;
+    } else if (config.auto_create) {
+        pv = new simPV();
+        pv->name = name;
+        pv->values.assign(1, 0.0);
+        _stamp(pv);
+        pvs[name] = pv;
+    }
+    simChannel* ch = new simChannel();
+    ch->id = nextId++;
+    ch->name = name;
+    ch->pv = pv;
+    ch->conn_callback = conn_callback;
+    ch->puser = puser;
+    ch->connectAt = _due();
+    ch->first = first;
+    ch->last = last;
+    channels[ch->id] = ch;
+    *channel = reinterpret_cast<chid>(ch);
+
+    if (conn_callback == nullptr) {
+        //ca_pend_io waits for channels created without a connection handler
+        pendingDue = pv != nullptr ? std::max(pendingDue, ch->connectAt) : clock::time_point::max();
+    } else if (pv != nullptr && pv->connected) {
+        uint64_t id = ch->id;
+        _schedule(ch->connectAt, [this, id]() {
+            caCh* callback = nullptr;
+            chid found_channel = nullptr;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                auto found = channels.find(id);
+                if (found == channels.end() || !_connected(found->second)) {
+                    return;
+                }
+                callback = found->second->conn_callback;
+                found_channel = reinterpret_cast<chid>(found->second);
+            }
+            struct connection_handler_args args;
+            args.chid = found_channel;
+            args.op = CA_OP_CONN_UP;
+            callback(args);
+        });
+    }
+    return ECA_NORMAL;
+}
+
+int caSimTransport::clear_channel(chid channel) {
+    std::unique_lock<std::mutex> lock(mutex);
+    _wait_callback(lock);
+    simChannel* ch = _channel(channel);
+    for (auto it = subscriptions.begin(); it != subscriptions.end();) {
+        if (it->second->channel == ch->id) {
+            if (ch->pv != nullptr) {
+                std::erase(ch->pv->subscriptions, it->first);
+            }
+            delete it->second;
+            it = subscriptions.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    std::erase_if(pendingGets, [&](const pendingGet& get) {return get.channel == ch->id;});
+    channels.erase(ch->id);
+    delete ch;
+    return ECA_NORMAL;
+}
+
+int caSimTransport::array_get(chtype type, unsigned long count, chid channel, void* value) {
+    std::lock_guard<std::mutex> lock(mutex);
+    simChannel* ch = _channel(channel);
+    if (!_connected(ch)) {
+        return ECA_DISCONN;
+    }
+    if (!dbr_type_is_valid(type)) {
+        return ECA_BADTYPE;
+    }
+    pendingGets.push_back({ch->id, type, count, value});
+    pendingDue = std::max(pendingDue, _due());
+    if (_fail()) {
+        pendingFailure = true;
+    }
+    return ECA_NORMAL;
+}
+
+int caSimTransport::array_get_callback(chtype type, unsigned long count, chid channel,
+                                       caEventCallBackFunc* callback, void* usr) {
+    std::lock_guard<std::mutex> lock(mutex);
+    simChannel* ch = _channel(channel);
+    if (!_connected(ch)) {
+        return ECA_DISCONN;
+    }
+    uint64_t id = ch->id;
+    bool fail = _fail();
+    _schedule(_due(), [this, id, type, count, callback, usr, fail]() {
+        std::vector<char> buffer;
+        struct event_handler_args args;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto found = channels.find(id);
+            if (found == channels.end()) {
+                return;
+            }
+            simChannel* ch = found->second;
+            unsigned long n = count == 0 ? _visible(ch, ch->pv->values.size()) : count;
+            args.status = fail ? ECA_GETFAIL : ECA_NORMAL;
+            if (!fail) {
+                buffer.resize(dbr_size_n(type, n));
+                args.status = _encode(*ch->pv, type, n, buffer.data(), ch->first);
+            }
+            args.usr = usr;
+            args.chid = reinterpret_cast<chid>(ch);
+            args.type = type;
+            args.count = static_cast<long>(n);
+            args.dbr = args.status == ECA_NORMAL ? buffer.data() : nullptr;
+        }
+        callback(args);
+    });
+    return ECA_NORMAL;
+}
+
+int caSimTransport::array_put(chtype type, unsigned long count, chid channel, const void* value) {
+    std::lock_guard<std::mutex> lock(mutex);
+    simChannel* ch = _channel(channel);
+    if (!_connected(ch)) {
+        return ECA_DISCONN;
+    }
+    if (_fail()) {
+        if (exceptionHandler == nullptr) {
+            return ECA_PUTFAIL;
+        }
+        //Like CA, a rejected put without callback is reported later through the exception handler
+        caExceptionHandler* handler = exceptionHandler;
+        void* usr = exceptionUsr;
+        _schedule(_due(), [handler, usr, channel, type, count]() {
+            struct exception_handler_args args = {};
+            args.usr = usr;
+            args.chid = channel;
+            args.type = type;
+            args.count = static_cast<long>(count);
+            args.stat = ECA_PUTFAIL;
+            args.ctx = "simulated put failure";
+            handler(args);
+        });
+        return ECA_NORMAL;
+    }
+    int status = _decode(*ch->pv, type, count, value);
+    if (status == ECA_NORMAL) {
+        _changed(ch->pv);
+    }
+    return status;
+}
+
+int caSimTransport::array_put_callback(chtype type, unsigned long count, chid channel, const void* value,
+                                       caEventCallBackFunc* callback, void* usr) {
+    std::lock_guard<std::mutex> lock(mutex);
+    simChannel* ch = _channel(channel);
+    if (!_connected(ch)) {
+        return ECA_DISCONN;
+    }
+    //The request is copied now, like CA copies it into the send buffer
+    std::size_t bytes = count * dbr_value_size[type];
+    std::vector<char> data(static_cast<const char*>(value), static_cast<const char*>(value) + bytes);
+    uint64_t id = ch->id;
+    bool fail = _fail();
+    _schedule(_due(), [this, id, type, count, data, callback, usr, fail]() {
+        struct event_handler_args args;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto found = channels.find(id);
+            if (found == channels.end()) {
+                return;
+            }
+            simChannel* ch = found->second;
+            //Like CA, a put outstanding when the channel dropped completes with ECA_DISCONN
+            if (!_connected(ch)) {
+                args.status = ECA_DISCONN;
+            } else {
+                args.status = fail ? ECA_PUTFAIL : _decode(*ch->pv, type, count, data.data());
+            }
+            if (args.status == ECA_NORMAL) {
+                _changed(ch->pv);
+            }
+            args.usr = usr;
+            args.chid = reinterpret_cast<chid>(ch);
+            args.type = type;
+            args.count = static_cast<long>(count);
+            args.dbr = nullptr;
+        }
+        callback(args);
+    });
+    return ECA_NORMAL;
+}
+
+int caSimTransport::create_subscription(chtype type, unsigned long count, chid channel, long mask,
+                                        caEventCallBackFunc* callback, void* usr, evid* monitor) {
+    std::lock_guard<std::mutex> lock(mutex);
+    simChannel* ch = _channel(channel);
+    if (!dbr_type_is_valid(type)) {
+        return ECA_BADTYPE;
+    }
+    simSubscription* sub = new simSubscription{nextId++, ch->id, type, count, mask, callback, usr};
+    subscriptions[sub->id] = sub;
+    *monitor = reinterpret_cast<evid>(sub);
+    if (ch->pv != nullptr) {
+        ch->pv->subscriptions.push_back(sub->id);
+        //Like CA, a new subscription receives the current value once connected
+        uint64_t id = sub->id;
+        _schedule(std::max(_due(), ch->connectAt), [this, id]() {_deliver(id);});
+    }
+    return ECA_NORMAL;
+}
+
+int caSimTransport::clear_subscription(evid monitor) {
+    std::unique_lock<std::mutex> lock(mutex);
+    _wait_callback(lock);
+    simSubscription* sub = reinterpret_cast<simSubscription*>(monitor);
+    simChannel* ch = channels[sub->channel];
+    if (ch != nullptr && ch->pv != nullptr) {
+        std::erase(ch->pv->subscriptions, sub->id);
+    }
+    subscriptions.erase(sub->id);
+    delete sub;
+    return ECA_NORMAL;
+}
+
+int caSimTransport::pend_io(double timeout) {
+    std::unique_lock<std::mutex> lock(mutex);
+    auto deadline = clock::now() + std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(timeout));
+    auto until = std::min(pendingDue, deadline);
+    if (until > clock::now()) {
+        lock.unlock();
+        std::this_thread::sleep_until(until);
+        lock.lock();
+    }
+    int status = ECA_NORMAL;
+    if (pendingDue > deadline || pendingFailure) {
+        status = ECA_TIMEOUT;
+    } else {
+        for (const pendingGet& get : pendingGets) {
+            auto found = channels.find(get.channel);
+            if (found == channels.end() || !_connected(found->second)) {
+                status = ECA_DISCONN;
+                continue;
+            }
+            simChannel* ch = found->second;
+            unsigned long count = get.count == 0 ? _visible(ch, ch->pv->values.size()) : get.count;
+            int get_status = _encode(*ch->pv, get.type, count, get.value, ch->first);
+            if (get_status != ECA_NORMAL) {
+                status = get_status;
+            }
+        }
+    }
+    pendingGets.clear();
+    pendingDue = clock::time_point();
+    pendingFailure = false;
+    return status;
+}
+
+int caSimTransport::pend_event(double timeout) {
+    std::this_thread::sleep_for(std::chrono::duration<double>(timeout));
+    return ECA_TIMEOUT;
+}
+
+int caSimTransport::flush_io() {
+    return ECA_NORMAL;
+}
+
+int caSimTransport::add_exception_event(caExceptionHandler* handler, void* usr) {
+    std::lock_guard<std::mutex> lock(mutex);
+    exceptionHandler = handler;
+    exceptionUsr = usr;
+    return ECA_NORMAL;
+}
+
+chtype caSimTransport::field_type(chid channel) {
+    std::lock_guard<std::mutex> lock(mutex);
+    simChannel* ch = _channel(channel);
+    return _connected(ch) ? ch->pv->type : static_cast<chtype>(TYPENOTCONN);
+}
+
+unsigned long caSimTransport::element_count(chid channel) {
+    std::lock_guard<std::mutex> lock(mutex);
+    simChannel* ch = _channel(channel);
+    return _connected(ch) ? _visible(ch, ch->pv->count) : 0;
+}
+
+enum channel_state caSimTransport::state(chid channel) {
+    std::lock_guard<std::mutex> lock(mutex);
+    simChannel* ch = _channel(channel);
+    if (ch->pv == nullptr || clock::now() < ch->connectAt) {
+        return cs_never_conn;
+    }
+    return ch->pv->connected ? cs_conn : cs_prev_conn;
+}
+
+const char* caSimTransport::name(chid channel) {
+    return _channel(channel)->name.c_str();
+}
+
+void* caSimTransport::puser(chid channel) {
+    return _channel(channel)->puser;
+}
+} // namespace epics
@@ -0,0 +1,34 @@
+/**
+ * @file caStats.cpp
+ * @brief Implementation of the per-PV operation counters.
+ */
+
+#include "caStats.h"
+
+namespace epics {
+
+counterSnapshot& counterSnapshot::operator+=(const counterSnapshot& other) {
+    gets += other.gets;
+    puts += other.puts;
+    monitor_events += other.monitor_events;
+    bytes_received += other.bytes_received;
+    bytes_sent += other.bytes_sent;
+    timeouts += other.timeouts;
+    disconnects += other.disconnects;
+    exceptions += other.exceptions;
+    return *this;
+}
+
+counterSnapshot caCounters::snapshot() const {
+    counterSnapshot m_snapshot;
+    m_snapshot.gets = gets.load();
+    m_snapshot.puts = puts.load();
+    m_snapshot.monitor_events = monitorEvents.load();
+    m_snapshot.bytes_received = bytesReceived.load();
+    m_snapshot.bytes_sent = bytesSent.load();
+    m_snapshot.timeouts = timeouts.load();
+    m_snapshot.disconnects = disconnects.load();
+    m_snapshot.exceptions = exceptions.load();
+    return m_snapshot;
+}
+} // namespace epics
@@ -0,0 +1,313 @@
+/**
+ * @file caTrace.cpp
+ * @brief Per-thread span buffers, Chrome trace export and the tracing transport decorator.
+ */
+
+#include "caTrace.h"
+
+#include <vector>
+#include <mutex>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <unistd.h>
+
+namespace epics {
+
+std::atomic<bool> caTracer::active{false};
+
+static std::mutex registryMutex;
+static std::vector<std::unique_ptr<traceBuffer>> registry;
+static std::atomic<uint64_t> traceGeneration{1};
+static std::atomic<std::size_t> traceCapacity{65536};
+static uint32_t nextTid = 1;
+
+//Marks the thread's buffer exited when the thread ends, since nobody else can append to it
+struct localBufferOwner {
+    traceBuffer* buffer = nullptr;
+    ~localBufferOwner() {
+        if (buffer != nullptr) {
+            buffer->exited.store(true, std::memory_order_release);
+            buffer = nullptr;
+        }
+    }
+};
+static thread_local localBufferOwner localOwner;
+
+void caTracer::start(std::size_t m_capacity) {
+    if (m_capacity == 0) {
+        throw std::runtime_error("Trace buffer capacity must be positive");
+    }
+    traceCapacity = m_capacity;
+    traceGeneration.fetch_add(1);
+    //Their events belong to the trace being discarded
+    release_exited();
+    active = true;
+}
+
+void caTracer::stop() {
+    active = false;
+}
+
+uint64_t caTracer::now() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+//The calling thread's buffer, created on first use and reset by its owner when a new trace starts
+traceBuffer* caTracer::_buffer() {
+    uint64_t m_generation = traceGeneration.load(std::memory_order_relaxed);
+    traceBuffer* localBuffer = localOwner.buffer;
+    if (localBuffer != nullptr && localBuffer->generation.load(std::memory_order_relaxed) == m_generation) {
+        return localBuffer;
+    }
+    std::lock_guard<std::mutex> lock(registryMutex);
+    if (localBuffer == nullptr) {
+        registry.push_back(std::make_unique<traceBuffer>());
+        localBuffer = registry.back().get();
+        localBuffer->tid = nextTid++;
+        localOwner.buffer = localBuffer;
+    }
+    std::size_t m_capacity = traceCapacity;
+    if (localBuffer->capacity != m_capacity) {
+        localBuffer->events = std::make_unique<traceEvent[]>(m_capacity);
+        localBuffer->capacity = m_capacity;
+    }
+    localBuffer->size = 0;
+    localBuffer->dropped = 0;
+    localBuffer->generation = m_generation;
+    return localBuffer;
+}
+
+void caTracer::record(const char* m_name, const char* m_pv, uint64_t m_begin, uint64_t m_end, int m_status) {
+    traceBuffer* buffer = _buffer();
+    std::size_t index = buffer->size.load(std::memory_order_relaxed);
+    if (index >= buffer->capacity) {
+        buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    traceEvent& event = buffer->events[index];
+    event.name = m_name;
+    event.begin_ns = m_begin;
+    event.end_ns = m_end;
+    event.status = m_status;
+    std::strncpy(event.pv, m_pv != nullptr ? m_pv : "", sizeof(event.pv) - 1);
+    event.pv[sizeof(event.pv) - 1] = '\0';
+    buffer->size.store(index + 1, std::memory_order_release);
+}
+
+uint64_t caTracer::get_dropped() {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    uint64_t m_generation = traceGeneration;
+    uint64_t m_dropped = 0;
+    for (auto& buffer : registry) {
+        if (buffer->generation == m_generation) {
+            m_dropped += buffer->dropped;
+        }
+    }
+    return m_dropped;
+}
+
+std::size_t caTracer::release_exited() {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    return std::erase_if(registry, [](const std::unique_ptr<traceBuffer>& buffer) {
+        return buffer->exited.load(std::memory_order_acquire);
+    });
+}
+
+static void write_json_string(std::FILE* file, const char* m_text) {
+    std::fputc('"', file);
+    for (const char* c = m_text; *c != '\0'; c++) {
+        if (*c == '"' || *c == '\\') {
+            std::fputc('\\', file);
+            std::fputc(*c, file);
+        } else if (static_cast<unsigned char>(*c) < 0x20) {
+            std::fprintf(file, "\\u%04x", static_cast<unsigned>(static_cast<unsigned char>(*c)));
+        } else {
+            std::fputc(*c, file);
+        }
+    }
+    std::fputc('"', file);
+}
+
+//Complete ("X") events with microsecond timestamps, one track per thread
+std::size_t caTracer::write_chrome_trace(std::string m_path) {
+    std::FILE* file = std::fopen(m_path.c_str(), "w");
+    if (file == nullptr) {
+        throw std::runtime_error("Failed to open trace file " + m_path);
+    }
+    long pid = static_cast<long>(getpid());
+    std::size_t written = 0;
+    std::lock_guard<std::mutex> lock(registryMutex);
+    uint64_t m_generation = traceGeneration;
+    std::fprintf(file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+    std::fprintf(file, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%ld,\"args\":{\"name\":\"EpicsProxy\"}}", pid);
+    for (auto& buffer : registry) {
+        if (buffer->generation != m_generation) {
+            continue;
+        }
+        std::fprintf(file, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%ld,\"tid\":%u,\"args\":{\"name\":\"thread %u\"}}",
+                     pid, buffer->tid, buffer->tid);
+        std::size_t m_size = buffer->size.load(std::memory_order_acquire);
+        for (std::size_t i = 0; i < m_size; i++) {
+            const traceEvent& event = buffer->events[i];
+            std::fprintf(file, ",\n{\"name\":\"%s\",\"cat\":\"ca\",\"ph\":\"X\",\"pid\":%ld,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"pv\":",
+                         event.name, pid, buffer->tid, event.begin_ns / 1000.0, (event.end_ns - event.begin_ns) / 1000.0);
+            write_json_string(file, event.pv);
+            std::fprintf(file, ",\"status\":%d}}", event.status);
+            written++;
+        }
+    }
+    std::fprintf(file, "\n]}\n");
+    if (std::fclose(file) != 0) {
+        throw std::runtime_error("Failed to write trace file " + m_path);
+    }
+    return written;
+}
+
+caTracingTransport* caTracingTransport::wrap(caTransport* m_inner) {
+    static std::mutex wrapMutex;
+    //Never freed, so no thread can be left inside a deleted decorator
+    static std::vector<caTracingTransport*>* decorators = new std::vector<caTracingTransport*>();
+    if (caTracingTransport* tracing = dynamic_cast<caTracingTransport*>(m_inner)) {
+        return tracing;
+    }
+    std::lock_guard<std::mutex> lock(wrapMutex);
+    for (caTracingTransport* decorator : *decorators) {
+        if (decorator->inner == m_inner) {
+            return decorator;
+        }
+    }
+    decorators->push_back(new caTracingTransport(m_inner));
+    return decorators->back();
+}
+
+int caTracingTransport::context_create(enum ca_preemptive_callback_select select) {
+    caTraceSpan span("ca_context_create", "");
+    int status = inner->context_create(select);
+    span.set_status(status);
+    return status;
+}
+
+void caTracingTransport::context_destroy() {
+    caTraceSpan span("ca_context_destroy", "");
+    inner->context_destroy();
+}
+
+struct ca_client_context* caTracingTransport::current_context() {
+    return inner->current_context();
+}
+
+int caTracingTransport::attach_context(struct ca_client_context* context) {
+    return inner->attach_context(context);
+}
+
+void caTracingTransport::detach_context() {
+    inner->detach_context();
+}
+
+int caTracingTransport::create_channel(const char* name, caCh* conn_callback, void* puser, unsigned priority, chid* channel) {
+    caTraceSpan span("ca_create_channel", name);
+    int status = inner->create_channel(name, conn_callback, puser, priority, channel);
+    span.set_status(status);
+    return status;
+}
+
+int caTracingTransport::clear_channel(chid channel) {
+    caTraceSpan span("ca_clear_channel", inner->name(channel));
+    int status = inner->clear_channel(channel);
+    span.set_status(status);
+    return status;
+}
+
+int caTracingTransport::array_get(chtype type, unsigned long count, chid channel, void* value) {
+    caTraceSpan span("ca_array_get", inner->name(channel));
+    int status = inner->array_get(type, count, channel, value);
+    span.set_status(status);
+    return status;
+}
+
+int caTracingTransport::array_get_callback(chtype type, unsigned long count, chid channel,
+                                           caEventCallBackFunc* callback, void* usr) {
+    caTraceSpan span("ca_array_get_callback", inner->name(channel));
+    int status = inner->array_get_callback(type, count, channel, callback, usr);
+    span.set_status(status);
+    return status;
+}
+
+int caTracingTransport::array_put(chtype type, unsigned long count, chid channel, const void* value) {
+    caTraceSpan span("ca_array_put", inner->name(channel));
+    int status = inner->array_put(type, count, channel, value);
+    span.set_status(status);
+    return status;
+}
+
+int caTracingTransport::array_put_callback(chtype type, unsigned long count, chid channel, const void* value,
+                                           caEventCallBackFunc* callback, void* usr) {
+    caTraceSpan span("ca_array_put_callback", inner->name(channel));
+    int status = inner->array_put_callback(type, count, channel, value, callback, usr);
+    span.set_status(status);
+    return status;
+}
+
+int caTracingTransport::create_subscription(chtype type, unsigned long count, chid channel, long mask,
+                                            caEventCallBackFunc* callback, void* usr, evid* monitor) {
+    caTraceSpan span("ca_create_subscription", inner->name(channel));
+    int status = inner->create_subscription(type, count, channel, mask, callback, usr, monitor);
+    span.set_status(status);
+    return status;
+}
+
+int caTracingTransport::clear_subscription(evid monitor) {
+    caTraceSpan span("ca_clear_subscription", "");
+    int status = inner->clear_subscription(monitor);
+    span.set_status(status);
+    return status;
+}
+
+int caTracingTransport::pend_io(double timeout) {
+    caTraceSpan span("ca_pend_io", "");
+    int status = inner->pend_io(timeout);
+    span.set_status(status);
+    return status;
+}
+
+int caTracingTransport::pend_event(double timeout) {
+    caTraceSpan span("ca_pend_event", "");
+    int status = inner->pend_event(timeout);
+    span.set_status(status);
+    return status;
+}
+
+int caTracingTransport::flush_io() {
+    caTraceSpan span("ca_flush_io", "");
+    int status = inner->flush_io();
+    span.set_status(status);
+    return status;
+}
+
+int caTracingTransport::add_exception_event(caExceptionHandler* handler, void* usr) {
+    return inner->add_exception_event(handler, usr);
+}
+
+chtype caTracingTransport::field_type(chid channel) {
+    return inner->field_type(channel);
+}
+
+unsigned long caTracingTransport::element_count(chid channel) {
+    return inner->element_count(channel);
+}
+
+enum channel_state caTracingTransport::state(chid channel) {
+    return inner->state(channel);
+}
+
+const char* caTracingTransport::name(chid channel) {
+    return inner->name(channel);
+}
+
+void* caTracingTransport::puser(chid channel) {
+    return inner->puser(channel);
+}
+} // namespace epics
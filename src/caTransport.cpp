@@ -0,0 +1,140 @@
+/**
+ * @file caTransport.cpp
+ * @brief Channel Access implementation of the transport interface and the current-transport registry.
+ */
+
+#include "caTransport.h"
+
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+
+namespace epics {
+
+static caChannelAccess channelAccess;
+//Atomic so a transport can be swapped (e.g. for tracing) while CA callback threads run
+static std::atomic<caTransport*> currentTransport{&channelAccess};
+
+caTransport* get_transport() {
+    return currentTransport.load(std::memory_order_acquire);
+}
+
+void set_transport(caTransport* m_transport) {
+    currentTransport.store(m_transport != nullptr ? m_transport : &channelAccess, std::memory_order_release);
+}
+
+static std::mutex bindingMutex;
+static std::size_t bindings = 0;
+static caTransport* boundTransport = nullptr;
+static caTransport* previousTransport = nullptr;
+
+void bind_transport(caTransport* m_transport) {
+    std::lock_guard<std::mutex> lock(bindingMutex);
+    if (bindings > 0 && m_transport != boundTransport) {
+        throw std::runtime_error("A CA context with a different transport is still alive; all contexts must share one transport");
+    }
+    if (bindings++ == 0) {
+        previousTransport = get_transport();
+        boundTransport = m_transport;
+        set_transport(m_transport);
+    }
+}
+
+void unbind_transport() {
+    std::lock_guard<std::mutex> lock(bindingMutex);
+    if (bindings > 0 && --bindings == 0) {
+        set_transport(previousTransport);
+    }
+}
+
+int caChannelAccess::context_create(enum ca_preemptive_callback_select select) {
+    return ca_context_create(select);
+}
+
+void caChannelAccess::context_destroy() {
+    ca_context_destroy();
+}
+
+struct ca_client_context* caChannelAccess::current_context() {
+    return ca_current_context();
+}
+
+int caChannelAccess::attach_context(struct ca_client_context* context) {
+    return ca_attach_context(context);
+}
+
+void caChannelAccess::detach_context() {
+    ca_detach_context();
+}
+
+int caChannelAccess::create_channel(const char* name, caCh* conn_callback, void* puser, unsigned priority, chid* channel) {
+    return ca_create_channel(name, conn_callback, puser, priority, channel);
+}
+
+int caChannelAccess::clear_channel(chid channel) {
+    return ca_clear_channel(channel);
+}
+
+int caChannelAccess::array_get(chtype type, unsigned long count, chid channel, void* value) {
+    return ca_array_get(type, count, channel, value);
+}
+
+int caChannelAccess::array_get_callback(chtype type, unsigned long count, chid channel,
+                                        caEventCallBackFunc* callback, void* usr) {
+    return ca_array_get_callback(type, count, channel, callback, usr);
+}
+
+int caChannelAccess::array_put(chtype type, unsigned long count, chid channel, const void* value) {
+    return ca_array_put(type, count, channel, value);
+}
+
+int caChannelAccess::array_put_callback(chtype type, unsigned long count, chid channel, const void* value,
+                                        caEventCallBackFunc* callback, void* usr) {
+    return ca_array_put_callback(type, count, channel, value, callback, usr);
+}
+
+int caChannelAccess::create_subscription(chtype type, unsigned long count, chid channel, long mask,
+                                         caEventCallBackFunc* callback, void* usr, evid* monitor) {
+    return ca_create_subscription(type, count, channel, mask, callback, usr, monitor);
+}
+
+int caChannelAccess::clear_subscription(evid monitor) {
+    return ca_clear_subscription(monitor);
+}
+
+int caChannelAccess::pend_io(double timeout) {
+    return ca_pend_io(timeout);
+}
+
+int caChannelAccess::pend_event(double timeout) {
+    return ca_pend_event(timeout);
+}
+
+int caChannelAccess::flush_io() {
+    return ca_flush_io();
+}
+
+int caChannelAccess::add_exception_event(caExceptionHandler* handler, void* usr) {
+    return ca_add_exception_event(handler, usr);
+}
+
+chtype caChannelAccess::field_type(chid channel) {
+    return ca_field_type(channel);
+}
+
+unsigned long caChannelAccess::element_count(chid channel) {
+    return ca_element_count(channel);
+}
+
+enum channel_state caChannelAccess::state(chid channel) {
+    return ca_state(channel);
+}
+
+const char* caChannelAccess::name(chid channel) {
+    return ca_name(channel);
+}
+
+void* caChannelAccess::puser(chid channel) {
+    return ca_puser(channel);
+}
+} // namespace epics
@@ -0,0 +1,40 @@
+/**
+ * @file caTripleBuffer.cpp
+ * @brief Lock-free hand-off of the newest monitored waveform between two threads.
+ */
+
+#include "caTripleBuffer.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace epics {
+
+caTripleBuffer::caTripleBuffer(chtype m_type, unsigned long m_capacity) {
+    for (arrayFrame& frame : frames) {
+        frame.type = m_type;
+        frame.data.resize(dbr_size_n(m_type, m_capacity));
+    }
+}
+
+void caTripleBuffer::publish(const void* m_values, unsigned long m_count) {
+    arrayFrame& frame = frames[back];
+    //dbr_size_n would count one element for an empty dynamic-size event
+    std::size_t bytes = std::min<std::size_t>(m_count * dbr_value_size[frame.type], frame.data.size());
+    std::memcpy(frame.data.data(), m_values, bytes);
+    frame.count = static_cast<unsigned long>(bytes / dbr_value_size[frame.type]);
+    frame.sequence = ++published;
+    unsigned previous = middle.exchange(back | FRESH, std::memory_order_acq_rel);
+    if (previous & FRESH) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+    back = previous & ~FRESH;
+}
+
+const arrayFrame* caTripleBuffer::latest() {
+    if (middle.load(std::memory_order_relaxed) & FRESH) {
+        front = middle.exchange(front, std::memory_order_acq_rel) & ~FRESH;
+    }
+    return &frames[front];
+}
+} // namespace epics
@@ -0,0 +1,113 @@
+/**
+ * @file caWriteBuffer.cpp
+ * @brief Implementation of the flush policy for buffered (fire-and-forget) CA puts.
+ */
+
+#include "caWriteBuffer.h"
+
+namespace epics {
+
+//m_context is the CA context the puts are queued in; nullptr takes the caller's
+caWriteBuffer::caWriteBuffer(flushPolicy m_policy, struct ca_client_context* m_context) {
+    policy = m_policy;
+    context = m_context != nullptr ? m_context : get_transport()->current_context();
+    std::lock_guard<std::mutex> lock(mutex);
+    _start_age_thread();
+}
+
+caWriteBuffer::~caWriteBuffer() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    changed.notify_all();
+    if (ageThread.joinable()) {
+        ageThread.join();
+    }
+    flush();
+}
+
+void caWriteBuffer::set_policy(flushPolicy m_policy) {
+    std::lock_guard<std::mutex> lock(mutex);
+    policy = m_policy;
+    _start_age_thread();
+    changed.notify_all();
+}
+
+//Caller must hold the mutex. The thread is started by the first policy with an age
+//threshold and then kept until the buffer is deleted.
+void caWriteBuffer::_start_age_thread() {
+    if (policy.max_usec != 0 && !ageThread.joinable()) {
+        ageThread = std::thread(&caWriteBuffer::_age_loop, this);
+    }
+}
+
+void caWriteBuffer::_age_loop() {
+    SEVCHK(get_transport()->attach_context(context), "Failed to attach write buffer thread");
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!stopping) {
+        if (policy.max_usec == 0 || queuedCount == 0) {
+            changed.wait(lock);
+            continue;
+        }
+        auto deadline = firstQueued + std::chrono::microseconds(policy.max_usec);
+        if (std::chrono::steady_clock::now() >= deadline) {
+            _flush();
+        } else {
+            changed.wait_until(lock, deadline);
+        }
+    }
+    lock.unlock();
+    get_transport()->detach_context();
+}
+
+flushPolicy caWriteBuffer::get_policy() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return policy;
+}
+
+void caWriteBuffer::queued(std::size_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto now = std::chrono::steady_clock::now();
+    if (queuedCount == 0) {
+        firstQueued = now;
+        changed.notify_all();
+    }
+    queuedCount++;
+    queuedBytes += bytes;
+
+    bool full = (policy.max_count != 0 && queuedCount >= policy.max_count) ||
+                (policy.max_bytes != 0 && queuedBytes >= policy.max_bytes);
+    bool stale = policy.max_usec != 0 &&
+                 std::chrono::duration_cast<std::chrono::microseconds>(now - firstQueued).count() >=
+                     static_cast<long long>(policy.max_usec);
+    if (full || stale) {
+        _flush();
+    }
+}
+
+void caWriteBuffer::flush() {
+    std::lock_guard<std::mutex> lock(mutex);
+    _flush();
+}
+
+//Caller must hold the mutex
+void caWriteBuffer::_flush() {
+    if (queuedCount == 0) {
+        return;
+    }
+    SEVCHK(get_transport()->flush_io(), "Failed to flush buffered puts");
+    queuedCount = 0;
+    queuedBytes = 0;
+}
+
+unsigned long caWriteBuffer::get_queued_count() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return queuedCount;
+}
+
+std::size_t caWriteBuffer::get_queued_bytes() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return queuedBytes;
+}
+} // namespace epics
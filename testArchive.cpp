@@ -0,0 +1,139 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+
+#include <unistd.h>
+
+#include "caArchive.h"
+
+using namespace epics;
+
+//Round trips and recovery of caArchive files; needs no IOC
+static int failures = 0;
+
+static void check(bool m_ok, std::string m_what) {
+    std::cout << (m_ok ? "ok    " : "FAIL  ") << m_what << std::endl;
+    if (!m_ok) {
+        failures++;
+    }
+}
+
+//Bitwise, so NaN, infinities and negative zero must come back unchanged
+static bool same(const std::vector<archiveSample>& m_read, const std::vector<archiveSample>& m_written) {
+    if (m_read.size() != m_written.size()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < m_read.size(); i++) {
+        if (m_read[i].timestamp != m_written[i].timestamp ||
+            std::memcmp(&m_read[i].value, &m_written[i].value, sizeof(double)) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main() {
+    std::string path = "/tmp/testArchive." + std::to_string(getpid()) + ".epa";
+    try {
+        //PV 0 walks slowly, PV 1 holds the values that stress the XOR coder, PV 2 stays empty
+        std::vector<archiveSample> slow;
+        std::vector<archiveSample> odd;
+        for (int i = 0; i < 1000; i++) {
+            slow.push_back({1000000000LL * i + (i % 7) * 1000, 10.0 + 0.001 * i});
+        }
+        //1.0 followed by -1.0000000000000002 differs in the sign bit and the last mantissa
+        //bit, so the XOR has no leading or trailing zeros and 64 significant bits, which
+        //the 6-bit length field stores as 0
+        double edge = -1.0000000000000002;
+        std::vector<double> values = {1.0, edge, 1.0, 1.0, 0.0, -0.0, std::numeric_limits<double>::infinity(),
+                                      std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::denorm_min(),
+                                      std::numeric_limits<double>::max(), -std::numeric_limits<double>::max(), edge};
+        int64_t stamp = 5;
+        for (std::size_t i = 0; i < values.size(); i++) {
+            //Irregular steps, backwards ones included, exercise every delta-of-delta width
+            stamp += (i % 3 == 0) ? 1 : (i % 3 == 1) ? 1000000007LL : -3;
+            odd.push_back({stamp, values[i]});
+        }
+
+        {
+            caArchiveWriter writer(path, {"slow", "odd", "empty"}, 64, 4);
+            for (std::size_t i = 0; i < std::max(slow.size(), odd.size()); i++) {
+                if (i < slow.size()) {
+                    writer.append(0, slow[i].timestamp, slow[i].value);
+                }
+                if (i < odd.size()) {
+                    writer.append(1, odd[i].timestamp, odd[i].value);
+                }
+            }
+            writer.close();
+            check(writer.get_samples_written() == slow.size() + odd.size(), "every sample is counted");
+        }
+
+        {
+            caArchiveReader reader(path);
+            check(reader.is_complete(), "a closed archive has its footer");
+            check(reader.get_pv_names().size() == 3 && reader.get_pv_names()[2] == "empty", "names round trip");
+            check(same(reader.read(0), slow), "a slowly changing PV round trips over many blocks");
+            check(same(reader.read(1), odd), "64 significant bits, NaN and infinities round trip");
+            check(reader.read(2).empty(), "a PV without samples reads back empty");
+            bool noEmptyBlocks = true;
+            for (const archiveIndexEntry& block : reader.get_blocks()) {
+                noEmptyBlocks = noEmptyBlocks && block.count > 0 && block.pv_index != 2;
+            }
+            check(noEmptyBlocks, "close writes no empty blocks");
+
+            std::vector<archiveSample> window = reader.read(0, slow[100].timestamp, slow[199].timestamp);
+            check(window.size() == 100 && window.front().timestamp == slow[100].timestamp, "a time range reads only its samples");
+            check(reader.read(0, -10, -1).empty(), "a range before the first sample is empty");
+        }
+
+        archiveBlockHeader header = {};
+        check(caArchiveReader::decode_block(header, nullptr).empty(), "a block of no samples decodes to nothing");
+
+        //Without the footer the reader rebuilds the index by scanning
+        std::FILE* file = std::fopen(path.c_str(), "rb");
+        std::fseek(file, 0, SEEK_END);
+        long size = std::ftell(file);
+        std::fclose(file);
+        check(truncate(path.c_str(), size - static_cast<long>(sizeof(archiveFooter))) == 0, "footer removed");
+        {
+            caArchiveReader reader(path);
+            check(!reader.is_complete(), "a missing footer is detected");
+            check(same(reader.read(0), slow) && same(reader.read(1), odd), "every block is recovered by scanning");
+        }
+
+        //A block cut off by a crash is dropped, and the blocks before it are kept
+        {
+            caArchiveWriter writer(path, {"slow"}, 64, 4);
+            for (const archiveSample& sample : slow) {
+                writer.append(0, sample.timestamp, sample.value);
+            }
+            writer.close();
+        }
+        file = std::fopen(path.c_str(), "rb");
+        std::fseek(file, 0, SEEK_END);
+        size = std::ftell(file);
+        std::fclose(file);
+        truncate(path.c_str(), size - static_cast<long>(sizeof(archiveFooter)) - 200);
+        {
+            caArchiveReader reader(path);
+            std::vector<archiveSample> recovered = reader.read(0);
+            bool prefix = !recovered.empty() && recovered.size() < slow.size() && recovered.size() % 64 == 0;
+            for (std::size_t i = 0; prefix && i < recovered.size(); i++) {
+                prefix = recovered[i].timestamp == slow[i].timestamp && recovered[i].value == slow[i].value;
+            }
+            check(!reader.is_complete() && prefix, "a torn last block is dropped");
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        failures++;
+    }
+    std::remove(path.c_str());
+    std::cout << (failures == 0 ? "All checks passed" : std::to_string(failures) + " checks failed") << std::endl;
+    return failures == 0 ? 0 : 1;
+}
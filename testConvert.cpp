@@ -0,0 +1,108 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+#include "caConvert.h"
+
+using namespace epics;
+
+//Checks that every SIMD level of caConvert agrees with a plain loop, including the
+//lengths that leave a tail after the last full vector; needs no IOC
+static int failures = 0;
+
+static void check(bool m_ok, std::string m_what) {
+    std::cout << (m_ok ? "ok    " : "FAIL  ") << m_what << std::endl;
+    if (!m_ok) {
+        failures++;
+    }
+}
+
+static const std::size_t lengths[] = {0, 1, 3, 7, 8, 15, 16, 17, 31, 64, 1003};
+
+//Negative values for the signed types. With m_extremes the ends hold the type's limits,
+//which sums cannot take without losing the small values, so only conversions use them.
+template<typename Wire>
+static std::vector<Wire> make_source(std::size_t m_count, bool m_extremes) {
+    std::vector<Wire> source(m_count);
+    for (std::size_t i = 0; i < m_count; i++) {
+        long long value = static_cast<long long>((i * 2654435761u) % 251) - 100;
+        source[i] = static_cast<Wire>(value);
+    }
+    if (m_extremes && m_count > 1) {
+        source.front() = std::numeric_limits<Wire>::lowest();
+        source.back() = std::numeric_limits<Wire>::max();
+    }
+    return source;
+}
+
+template<typename Wire>
+static void check_type(std::string m_name, chtype m_type) {
+    simdLevel best = caConvert::detected();
+    bool converted = true;
+    bool scaled = true;
+    bool reduced = true;
+    for (std::size_t count : lengths) {
+        std::vector<Wire> source = make_source<Wire>(count, true);
+        std::vector<Wire> values = make_source<Wire>(count, false);
+        arrayStats expected;
+        expected.count = count;
+        for (std::size_t i = 0; i < count; i++) {
+            double value = static_cast<double>(values[i]);
+            expected.min = i == 0 ? value : std::min(expected.min, value);
+            expected.max = i == 0 ? value : std::max(expected.max, value);
+            expected.sum += value;
+            expected.weighted += i * value;
+        }
+        for (int level = SIMD_SCALAR; level <= best; level++) {
+            caConvert::set_level(static_cast<simdLevel>(level));
+            //One extra element that no kernel may write
+            std::vector<double> out(count + 1, -1.0);
+            caConvert::to_double(source.data(), m_type, out.data(), count);
+            for (std::size_t i = 0; i < count; i++) {
+                converted = converted && out[i] == static_cast<double>(source[i]);
+            }
+            converted = converted && out[count] == -1.0;
+
+            caConvert::to_double(source.data(), m_type, out.data(), count, 0.0125, -3.5);
+            for (std::size_t i = 0; i < count; i++) {
+                double reference = 0.0125 * static_cast<double>(source[i]) - 3.5;
+                scaled = scaled && std::fabs(out[i] - reference) <= 1e-15 * std::max(1.0, std::fabs(reference));
+            }
+
+            arrayStats stats = caConvert::reduce(values.data(), m_type, count);
+            reduced = reduced && stats.count == expected.count && stats.min == expected.min && stats.max == expected.max &&
+                      std::fabs(stats.sum - expected.sum) <= 1e-12 * std::max(1.0, std::fabs(expected.sum)) &&
+                      std::fabs(stats.weighted - expected.weighted) <= 1e-12 * std::max(1.0, std::fabs(expected.weighted));
+        }
+    }
+    caConvert::set_level(best);
+    check(converted, m_name + " converts exactly at every level");
+    check(scaled, m_name + " scaled conversion agrees at every level");
+    check(reduced, m_name + " reductions agree at every level");
+}
+
+int main() {
+    std::cout << "SIMD levels up to " << caConvert::level_name(caConvert::detected()) << std::endl;
+    check_type<dbr_double_t>("double", DBR_DOUBLE);
+    check_type<dbr_float_t>("float", DBR_FLOAT);
+    check_type<dbr_long_t>("long", DBR_LONG);
+    check_type<dbr_short_t>("short", DBR_SHORT);
+    check_type<dbr_enum_t>("enum", DBR_ENUM);
+    check_type<dbr_char_t>("char", DBR_CHAR);
+
+    bool refused = false;
+    try {
+        double out;
+        caConvert::to_double("text", DBR_STRING, &out, 1);
+    } catch (const std::exception&) {
+        refused = true;
+    }
+    check(refused, "strings are refused");
+
+    std::cout << (failures == 0 ? "All checks passed" : std::to_string(failures) + " checks failed") << std::endl;
+    return failures == 0 ? 0 : 1;
+}
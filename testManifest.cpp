@@ -0,0 +1,96 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <stdexcept>
+
+#include <unistd.h>
+
+#include "caManifest.h"
+
+using namespace epics;
+
+//Parsing of PV manifest files, good and bad; needs no IOC
+static int failures = 0;
+static std::string path = "/tmp/testManifest." + std::to_string(getpid()) + ".txt";
+
+static void check(bool m_ok, std::string m_what) {
+    std::cout << (m_ok ? "ok    " : "FAIL  ") << m_what << std::endl;
+    if (!m_ok) {
+        failures++;
+    }
+}
+
+static void write_manifest(std::string m_text) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file << m_text;
+}
+
+//The error message of a manifest that must be refused, empty if it was accepted
+static std::string refusal(std::string m_text) {
+    write_manifest(m_text);
+    try {
+        caManifest manifest(path);
+    } catch (const std::runtime_error& e) {
+        return e.what();
+    }
+    return "";
+}
+
+static bool mentions(std::string m_message, std::string m_part) {
+    return m_message.find(m_part) != std::string::npos;
+}
+
+int main() {
+    try {
+        write_manifest("# motors\n"
+                       "\n"
+                       "m1.VAL double 50\n"
+                       "m1.RBV\tdouble\t# readback\n"
+                       "   m1.DESC string\r\n"
+                       "m1.MSTA - 0\n"
+                       "m1.VAL long\n"
+                       "m1.DMOV short 99");
+        caManifest manifest(path);
+        const std::vector<manifestEntry>& entries = manifest.get_entries();
+        check(entries.size() == 5, "comments and blank lines are skipped");
+        check(manifest.get_duplicates() == 1, "a repeated name is counted as a duplicate");
+        check(entries.size() == 5 && entries[0].name == "m1.VAL" && entries[0].type == DBR_DOUBLE && entries[0].priority == 50,
+              "name, type and priority");
+        check(entries.size() == 5 && entries[1].name == "m1.RBV" && entries[1].priority == 20, "tabs separate fields and priority defaults to 20");
+        check(entries.size() == 5 && entries[2].name == "m1.DESC" && entries[2].type == DBR_STRING, "leading blanks and CRLF endings");
+        check(entries.size() == 5 && entries[3].type == TYPENOTCONN && entries[3].priority == 0, "\"-\" skips the type check");
+        check(entries.size() == 5 && entries[4].name == "m1.DMOV" && entries[4].priority == 99, "the last line needs no newline");
+
+        write_manifest("");
+        caManifest empty(path);
+        check(empty.get_entries().empty(), "an empty manifest has no entries");
+
+        std::string message = refusal("m1.VAL double\nm1.RBV quad\n");
+        check(mentions(message, "quad"), "an unknown type is refused");
+        message = refusal("m1.VAL double\n\nm1.RBV double 2x\n");
+        check(mentions(message, "line 3") && mentions(message, "bad priority"), "a priority that is not a number is refused with its line");
+        message = refusal("m1.VAL double -1\n");
+        check(mentions(message, "bad priority"), "a negative priority is refused");
+        message = refusal("m1.VAL double 100\n");
+        check(mentions(message, "above 99"), "a priority above 99 is refused");
+        message = refusal("m1.VAL double 20 extra\n");
+        check(mentions(message, "line 1") && mentions(message, "too many fields"), "a fourth field is refused");
+
+        std::remove(path.c_str());
+        bool missing = false;
+        try {
+            caManifest absent(path);
+        } catch (const std::runtime_error&) {
+            missing = true;
+        }
+        check(missing, "a missing file is refused");
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        failures++;
+    }
+    std::remove(path.c_str());
+    std::cout << (failures == 0 ? "All checks passed" : std::to_string(failures) + " checks failed") << std::endl;
+    return failures == 0 ? 0 : 1;
+}
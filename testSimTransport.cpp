@@ -0,0 +1,88 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "EpicsProxy.h"
+
+using namespace epics;
+
+//Smoke test of the library against caSimTransport; needs no IOC
+static int failures = 0;
+static std::atomic<int> events{0};
+
+static void check(bool m_ok, std::string m_what) {
+    std::cout << (m_ok ? "ok    " : "FAIL  ") << m_what << std::endl;
+    if (!m_ok) {
+        failures++;
+    }
+}
+
+static void count_events(struct event_handler_args args) {
+    if (args.status == ECA_NORMAL) {
+        events++;
+    }
+}
+
+int main() {
+    try {
+        caTransport* before = get_transport();
+        simConfig sim_conf;
+        sim_conf.latency = 0.001;
+        caSimTransport sim(sim_conf);
+        sim.add_pv("sim:wf", DBR_SHORT, 8, 3);
+
+        struct caConfig conf = {"", "", "", "", "", "", "", ""};
+        conf.transport = &sim;
+        {
+            EpicsProxy proxy("first");
+            proxy.init("sim:", {"x", "wf"}, conf);
+            EpicsProxy second("second");
+            second.init("sim:", {"x"}, conf);
+            check(get_transport() == &sim, "proxies install the simulated transport");
+
+            //Scalars and arrays round trip
+            proxy.write_pv<double>("x", 4.5);
+            check(second.read_pv<double>("x") == 4.5, "a write is seen through a second proxy");
+            proxy.write_pv_array<short>("wf", {1, 2, 3});
+            std::vector<short> array = proxy.read_pv_array<short>("wf");
+            check(array.size() == 8 && array[0] == 1 && array[2] == 3, "array write and read");
+
+            //Monitors see the initial value and periodic updates
+            proxy.add_monitor("x", &proxy, count_events);
+            sim.set_update_rate("sim:x", 500);
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            sim.set_update_rate("sim:x", 0);
+            check(events > 10, "monitor events arrive");
+
+            //Disconnects are seen and recovered from
+            sim.disconnect("sim:x");
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            check(!proxy.get_pv("x")->is_connected(), "disconnect is reported");
+            sim.reconnect("sim:x");
+            check(proxy.get_pv("x")->wait_connected(1.0), "channel reconnects");
+
+            //Contexts share the process-wide transport, so a different one is refused
+            caSimTransport other;
+            struct caConfig other_conf = conf;
+            other_conf.transport = &other;
+            bool refused = false;
+            try {
+                EpicsProxy third("third");
+                third.init("sim:", {"x"}, other_conf);
+            } catch (const std::exception&) {
+                refused = true;
+            }
+            check(refused, "a proxy with a different transport is refused");
+            check(get_transport() == &sim, "the refused proxy leaves the transport alone");
+        }
+        check(get_transport() == before, "the last proxy restores the previous transport");
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        failures++;
+    }
+    std::cout << (failures == 0 ? "All checks passed" : std::to_string(failures) + " checks failed") << std::endl;
+    return failures == 0 ? 0 : 1;
+}